@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "interval.hpp"
+
+//----------------------------------------------------------------------------------------
+// constantes intervalares por precisão.
+//
+// literal<Prec>("0.1") devolve o intervalo [RNDD(0.1), RNDU(0.1)], que contém o valor
+// decimal exato. Cada literal é convertido uma única vez por precisão; as referências
+// devolvidas ficam válidas até o fim do programa. A consulta passa primeiro por um
+// cache da própria thread, sem lock, e só então pelo cache global.
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    template <size_t Prec>
+    const interval<mpfr_t, Prec> &literal(std::string_view text)
+    {
+        using interval_t = interval<mpfr_t, Prec>;
+
+        static std::shared_mutex mutex;
+        static std::map<std::string, interval_t, std::less<>> shared;
+        thread_local std::map<std::string, const interval_t *, std::less<>> local;
+
+        if (auto it = local.find(text); it != local.end())
+        {
+            return *it->second;
+        }
+
+        const interval_t *found = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            if (auto it = shared.find(text); it != shared.end())
+            {
+                found = &it->second;
+            }
+        }
+
+        if (found == nullptr)
+        {
+            std::string key(text);
+
+            mpfr_t lo, hi;
+            mpfr_inits2(Prec, lo, hi, NULL);
+
+            if (mpfr_set_str(lo, key.c_str(), 10, MPFR_RNDD) != 0 || mpfr_set_str(hi, key.c_str(), 10, MPFR_RNDU) != 0)
+            {
+                mpfr_clears(lo, hi, NULL);
+                throw std::invalid_argument("Invalid string for MPFR number.");
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            found = &shared.try_emplace(key, lo, hi).first->second;
+
+            mpfr_clears(lo, hi, NULL);
+        }
+
+        local.emplace(std::string(text), found);
+        return *found;
+    }
+
+    //---------------------------------------
+    // pi, e and ln 2 enclosures
+    //---------------------------------------
+
+    template <size_t Prec>
+    const interval<mpfr_t, Prec> &const_pi()
+    {
+        static const interval<mpfr_t, Prec> value = []
+        {
+            mpfr_t lo, hi;
+            mpfr_inits2(Prec, lo, hi, NULL);
+            mpfr_const_pi(lo, MPFR_RNDD);
+            mpfr_const_pi(hi, MPFR_RNDU);
+            interval<mpfr_t, Prec> r(lo, hi);
+            mpfr_clears(lo, hi, NULL);
+            return r;
+        }();
+        return value;
+    }
+
+    template <size_t Prec>
+    const interval<mpfr_t, Prec> &const_e()
+    {
+        static const interval<mpfr_t, Prec> value = []
+        {
+            mpfr_t lo, hi;
+            mpfr_inits2(Prec, lo, hi, NULL);
+            mpfr_set_ui(lo, 1, MPFR_RNDN);
+            mpfr_set_ui(hi, 1, MPFR_RNDN);
+            mpfr_exp(lo, lo, MPFR_RNDD);
+            mpfr_exp(hi, hi, MPFR_RNDU);
+            interval<mpfr_t, Prec> r(lo, hi);
+            mpfr_clears(lo, hi, NULL);
+            return r;
+        }();
+        return value;
+    }
+
+    template <size_t Prec>
+    const interval<mpfr_t, Prec> &const_ln2()
+    {
+        static const interval<mpfr_t, Prec> value = []
+        {
+            mpfr_t lo, hi;
+            mpfr_inits2(Prec, lo, hi, NULL);
+            mpfr_const_log2(lo, MPFR_RNDD);
+            mpfr_const_log2(hi, MPFR_RNDU);
+            interval<mpfr_t, Prec> r(lo, hi);
+            mpfr_clears(lo, hi, NULL);
+            return r;
+        }();
+        return value;
+    }
+} // namespace flib
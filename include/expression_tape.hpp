@@ -0,0 +1,526 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "autodiff.hpp"
+#include "constants.hpp"
+#include "elementary_functions.hpp"
+#include "interval.hpp"
+
+//----------------------------------------------------------------------------------------
+// expressões em tempo de execução.
+//
+// tape::parse("sin(x)/exp(x) - x^2") compila a expressão uma única vez para uma fita em
+// notação pós-fixa, que depois é avaliada para qualquer tipo com tape_ops: double, fdh
+// ou interval<mpfr_t, Prec>. Gramática:
+//
+//   expr    = term { ('+' | '-') term }
+//   term    = unary { ('*' | '/') unary }
+//   unary   = '-' unary | power
+//   power   = primary [ '^' ['-'] integer ]
+//   primary = number | 'x' | name '(' expr ')' | '(' expr ')'
+//   number  = digits [ '.' digits ] [ ('e' | 'E') ['+' | '-'] digits ]
+//   name    = sin | cos | exp | log
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    enum class tape_op
+    {
+        constant,
+        variable,
+        add,
+        sub,
+        mul,
+        div,
+        neg,
+        pow,
+        sin,
+        cos,
+        exp,
+        log
+    };
+
+    struct tape_instruction
+    {
+        tape_op op;
+        double value;        // constant value, or the exponent of pow
+        std::string text;    // constant as written, for exact interval enclosures
+    };
+
+    //---------------------------------------
+    // per-type operations used by the tape
+    //---------------------------------------
+
+    template <class T>
+    struct tape_ops;
+
+    template <>
+    struct tape_ops<double>
+    {
+        static double constant(const tape_instruction &c) { return c.value; }
+        static double one() { return 1; }
+        static double sin(double x) { return std::sin(x); }
+        static double cos(double x) { return std::cos(x); }
+        static double exp(double x) { return std::exp(x); }
+        static double log(double x) { return std::log(x); }
+        static double pow(double x, int k) { return std::pow(x, k); }
+    };
+
+    template <>
+    struct tape_ops<fdh>
+    {
+        static fdh constant(const tape_instruction &c) { return fdh{c.value, 0, 0}; }
+        static fdh one() { return fdh{1, 0, 0}; }
+        static fdh sin(fdh x) { return flib::sin(x); }
+        static fdh cos(fdh x) { return flib::cos(x); }
+        static fdh exp(fdh x) { return flib::exp(x); }
+        static fdh log(fdh x) { return flib::log(x); }
+        static fdh pow(fdh x, int k) { return x_pwr_k(x, k); }
+    };
+
+    template <size_t Prec>
+    struct tape_ops<interval<mpfr_t, Prec>>
+    {
+        using interval_t = interval<mpfr_t, Prec>;
+
+        static interval_t constant(const tape_instruction &c) { return literal<Prec>(c.text); }
+        static interval_t one() { return interval_t(1.0, 1.0); }
+        static interval_t sin(const interval_t &x) { return interval_t::sin(x); }
+        static interval_t cos(const interval_t &x) { return interval_t::cos(x); }
+        static interval_t exp(const interval_t &x) { return interval_t::exp(x); }
+        static interval_t log(const interval_t &x) { return interval_t::log(x); }
+        static interval_t pow(const interval_t &x, int k) { return interval_t::x_pwr_k(x, k); }
+    };
+
+    class tape
+    {
+    private:
+        std::vector<tape_instruction> code;
+        std::size_t depth = 0;   // largest evaluation stack
+
+        //---------------------------------------
+        // recursive-descent parser
+        //---------------------------------------
+
+        struct parser
+        {
+            std::string_view s;
+            std::size_t i = 0;
+            std::vector<tape_instruction> &out;
+
+            [[noreturn]] void fail(const std::string &what) const
+            {
+                throw std::invalid_argument("Invalid expression at position " + std::to_string(i) + ": " + what);
+            }
+
+            void skip()
+            {
+                while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i])))
+                {
+                    ++i;
+                }
+            }
+
+            bool accept(char c)
+            {
+                skip();
+                if (i < s.size() && s[i] == c)
+                {
+                    ++i;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c)
+            {
+                if (!accept(c))
+                {
+                    fail(std::string("expected '") + c + "'");
+                }
+            }
+
+            void expr()
+            {
+                term();
+                while (true)
+                {
+                    if (accept('+'))
+                    {
+                        term();
+                        out.push_back({tape_op::add, 0, {}});
+                    }
+                    else if (accept('-'))
+                    {
+                        term();
+                        out.push_back({tape_op::sub, 0, {}});
+                    }
+                    else
+                    {
+                        return;
+                    }
+                }
+            }
+
+            void term()
+            {
+                unary();
+                while (true)
+                {
+                    if (accept('*'))
+                    {
+                        unary();
+                        out.push_back({tape_op::mul, 0, {}});
+                    }
+                    else if (accept('/'))
+                    {
+                        unary();
+                        out.push_back({tape_op::div, 0, {}});
+                    }
+                    else
+                    {
+                        return;
+                    }
+                }
+            }
+
+            void unary()
+            {
+                if (accept('-'))
+                {
+                    unary();
+                    out.push_back({tape_op::neg, 0, {}});
+                }
+                else
+                {
+                    power();
+                }
+            }
+
+            void power()
+            {
+                primary();
+                if (accept('^'))
+                {
+                    bool negative = accept('-');
+                    skip();
+                    std::size_t start = i;
+                    while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i])))
+                    {
+                        ++i;
+                    }
+                    if (start == i)
+                    {
+                        fail("expected an integer exponent");
+                    }
+                    int k = std::stoi(std::string(s.substr(start, i - start)));
+                    out.push_back({tape_op::pow, static_cast<double>(negative ? -k : k), {}});
+                }
+            }
+
+            std::size_t digits()
+            {
+                std::size_t start = i;
+                while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i])))
+                {
+                    ++i;
+                }
+                return i - start;
+            }
+
+            // decimal literal: digits [ '.' digits ] [ ('e' | 'E') ['+' | '-'] digits ],
+            // the forms literal<Prec> accepts
+            void number()
+            {
+                std::size_t start = i;
+                std::size_t n = digits();
+                if (i < s.size() && s[i] == '.')
+                {
+                    ++i;
+                    n += digits();
+                }
+                if (n == 0)
+                {
+                    fail("expected a number");
+                }
+
+                if (i < s.size() && (s[i] == 'e' || s[i] == 'E'))
+                {
+                    ++i;
+                    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+                    {
+                        ++i;
+                    }
+                    if (digits() == 0)
+                    {
+                        fail("expected an exponent");
+                    }
+                }
+
+                std::string text(s.substr(start, i - start));
+                out.push_back({tape_op::constant, std::strtod(text.c_str(), nullptr), text});
+            }
+
+            void primary()
+            {
+                skip();
+                if (i >= s.size())
+                {
+                    fail("unexpected end");
+                }
+
+                char c = s[i];
+                if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+                {
+                    number();
+                    return;
+                }
+
+                if (accept('('))
+                {
+                    expr();
+                    expect(')');
+                    return;
+                }
+
+                std::size_t start = i;
+                while (i < s.size() && std::isalpha(static_cast<unsigned char>(s[i])))
+                {
+                    ++i;
+                }
+                std::string_view name = s.substr(start, i - start);
+
+                if (name == "x")
+                {
+                    out.push_back({tape_op::variable, 0, {}});
+                    return;
+                }
+
+                tape_op op;
+                if (name == "sin")
+                {
+                    op = tape_op::sin;
+                }
+                else if (name == "cos")
+                {
+                    op = tape_op::cos;
+                }
+                else if (name == "exp")
+                {
+                    op = tape_op::exp;
+                }
+                else if (name == "log")
+                {
+                    op = tape_op::log;
+                }
+                else
+                {
+                    fail("unknown name '" + std::string(name) + "'");
+                }
+
+                expect('(');
+                expr();
+                expect(')');
+                out.push_back({op, 0, {}});
+            }
+        };
+
+    public:
+        static tape parse(std::string_view text)
+        {
+            tape t;
+            parser p{text, 0, t.code};
+            p.expr();
+            p.skip();
+            if (p.i != text.size())
+            {
+                p.fail("unexpected character");
+            }
+
+            std::size_t d = 0;
+            for (const tape_instruction &in : t.code)
+            {
+                switch (in.op)
+                {
+                case tape_op::constant:
+                case tape_op::variable:
+                    ++d;
+                    break;
+                case tape_op::add:
+                case tape_op::sub:
+                case tape_op::mul:
+                case tape_op::div:
+                    --d;
+                    break;
+                default:
+                    break;
+                }
+                t.depth = std::max(t.depth, d);
+            }
+            return t;
+        }
+
+        std::size_t size() const
+        {
+            return code.size();
+        }
+
+        //---------------------------------------
+        // f(x)
+        //---------------------------------------
+
+        template <class T>
+        T evaluate(const T &x) const
+        {
+            using ops = tape_ops<T>;
+
+            // reused across calls: no allocation per Newton step
+            thread_local std::vector<T> stack;
+            stack.clear();
+            stack.reserve(depth);
+
+            for (const tape_instruction &in : code)
+            {
+                switch (in.op)
+                {
+                case tape_op::constant:
+                    stack.push_back(ops::constant(in));
+                    continue;
+                case tape_op::variable:
+                    stack.push_back(x);
+                    continue;
+                default:
+                    break;
+                }
+
+                T &a = stack.back();
+                switch (in.op)
+                {
+                case tape_op::neg: a = -a; continue;
+                case tape_op::pow: a = ops::pow(a, static_cast<int>(in.value)); continue;
+                case tape_op::sin: a = ops::sin(a); continue;
+                case tape_op::cos: a = ops::cos(a); continue;
+                case tape_op::exp: a = ops::exp(a); continue;
+                case tape_op::log: a = ops::log(a); continue;
+                default: break;
+                }
+
+                T b = stack.back();
+                stack.pop_back();
+                T &l = stack.back();
+                switch (in.op)
+                {
+                case tape_op::add: l = l + b; break;
+                case tape_op::sub: l = l - b; break;
+                case tape_op::mul: l = l * b; break;
+                case tape_op::div: l = l / b; break;
+                default: break;
+                }
+            }
+
+            return stack.back();
+        }
+
+        //---------------------------------------
+        // {f(x), f'(x)} by forward mode over T,
+        // for types without a built-in derivative
+        // (intervals)
+        //---------------------------------------
+
+        template <class T>
+        std::pair<T, T> evaluate_with_derivative(const T &x) const
+        {
+            using ops = tape_ops<T>;
+
+            thread_local std::vector<std::pair<T, T>> stack;
+            stack.clear();
+            stack.reserve(depth);
+
+            T zero = ops::one() - ops::one();
+
+            for (const tape_instruction &in : code)
+            {
+                switch (in.op)
+                {
+                case tape_op::constant:
+                    stack.emplace_back(ops::constant(in), zero);
+                    continue;
+                case tape_op::variable:
+                    stack.emplace_back(x, ops::one());
+                    continue;
+                default:
+                    break;
+                }
+
+                auto &[v, d] = stack.back();
+                switch (in.op)
+                {
+                case tape_op::neg:
+                    v = -v;
+                    d = -d;
+                    continue;
+                case tape_op::pow:
+                {
+                    int k = static_cast<int>(in.value);
+                    T kk = ops::constant({tape_op::constant, in.value, std::to_string(k)});
+                    d = kk * ops::pow(v, k - 1) * d;
+                    v = ops::pow(v, k);
+                    continue;
+                }
+                case tape_op::sin:
+                    d = ops::cos(v) * d;
+                    v = ops::sin(v);
+                    continue;
+                case tape_op::cos:
+                    d = -(ops::sin(v) * d);
+                    v = ops::cos(v);
+                    continue;
+                case tape_op::exp:
+                    v = ops::exp(v);
+                    d = v * d;
+                    continue;
+                case tape_op::log:
+                    d = d / v;
+                    v = ops::log(v);
+                    continue;
+                default:
+                    break;
+                }
+
+                std::pair<T, T> b = stack.back();
+                stack.pop_back();
+                auto &[lv, ld] = stack.back();
+                switch (in.op)
+                {
+                case tape_op::add:
+                    lv = lv + b.first;
+                    ld = ld + b.second;
+                    break;
+                case tape_op::sub:
+                    lv = lv - b.first;
+                    ld = ld - b.second;
+                    break;
+                case tape_op::mul:
+                    ld = ld * b.first + lv * b.second;
+                    lv = lv * b.first;
+                    break;
+                case tape_op::div:
+                    lv = lv / b.first;
+                    ld = (ld - lv * b.second) / b.first;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            return stack.back();
+        }
+    };
+} // namespace flib
@@ -0,0 +1,320 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "interval.hpp"
+
+//----------------------------------------------------------------------------------------
+// otimização global intervalar (Moore–Skelboe / Hansen) com branch-and-bound paralelo.
+//
+// Os boxes ficam numa fila de prioridade compartilhada, ordenada pelo limite inferior
+// de f sobre o box. O melhor limite superior conhecido (incumbente) é um std::atomic
+// lido sem lock por todas as threads, de modo que um box é descartado assim que o seu
+// limite inferior passa do incumbente.
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    struct optimizer_options
+    {
+        double tolerance = 1e-10;   // boxes narrower than this are not split further
+        unsigned threads = 0;       // 0 = std::thread::hardware_concurrency()
+        std::size_t max_boxes = 1000000;
+    };
+
+    struct optimizer_box
+    {
+        double lo;
+        double hi;
+        double f_lower;   // lower bound of f over [lo, hi]
+    };
+
+    struct optimizer_result
+    {
+        double lower_bound;                 // guaranteed: min f >= lower_bound
+        double upper_bound;                 // guaranteed: min f <= upper_bound
+        double minimizer;                   // point at which upper_bound was certified
+        std::vector<optimizer_box> boxes;   // every global minimizer lies in one of them
+        std::size_t processed;
+    };
+
+    namespace detail
+    {
+        //---------------------------------------
+        // lock-free x = min(x, v)
+        //---------------------------------------
+
+        inline bool atomic_min(std::atomic<double> &x, double v)
+        {
+            double current = x.load(std::memory_order_relaxed);
+            while (v < current)
+            {
+                if (x.compare_exchange_weak(current, v, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        struct box_order
+        {
+            bool operator()(const optimizer_box &a, const optimizer_box &b) const
+            {
+                return a.f_lower > b.f_lower;
+            }
+        };
+    } // namespace detail
+
+    //----------------------------------------------------------------------------------------
+    // global_minimize
+    //
+    //   f   : interval -> interval, enclosure of f
+    //   df  : interval -> interval, enclosure of f'  (monotonicity test)
+    //   d2f : interval -> interval, enclosure of f'' (concavity test)
+    //   fp  : double -> double, plain evaluation of f used to improve the incumbent
+    //
+    // Minimizes f over [a, b]. A midpoint value from fp only becomes the new incumbent
+    // after f has been re-evaluated rigorously on the degenerate interval [m, m], so
+    // upper_bound is always a true upper bound. std::domain_error from f, df or d2f only
+    // disables a test on that box; any other exception stops the search and is rethrown
+    // to the caller after the worker threads have joined.
+    //----------------------------------------------------------------------------------------
+
+    template <size_t Prec, class F, class DF, class D2F, class FP>
+    optimizer_result global_minimize(F f, DF df, D2F d2f, FP fp, double a, double b, optimizer_options options = {})
+    {
+        using interval_t = interval<mpfr_t, Prec>;
+
+        if (a > b)
+        {
+            throw std::invalid_argument("Invalid interval: lower bound is greater than upper bound");
+        }
+
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        std::priority_queue<optimizer_box, std::vector<optimizer_box>, detail::box_order> queue;
+        std::vector<optimizer_box> candidates;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t active = 0;
+        std::size_t processed = 0;
+        std::exception_ptr error;   // first exception thrown by f, df, d2f or fp; guarded by mutex
+
+        std::atomic<double> incumbent{infinity};
+        double minimizer = (a + b) / 2;   // guarded by mutex
+
+        // rigorous upper bound of f at a point. The CAS keeps pruning lock-free; the
+        // point is published under the mutex, and only while v is still the incumbent,
+        // so minimizer always matches the final upper bound.
+        auto certify = [&](double x)
+        {
+            try
+            {
+                double v = f(interval_t(x, x)).sup();
+                if (detail::atomic_min(incumbent, v))
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    if (incumbent.load(std::memory_order_relaxed) == v)
+                    {
+                        minimizer = x;
+                    }
+                }
+            }
+            catch (const std::domain_error &)
+            {
+            }
+        };
+
+        // lower bound of f over the box, -inf when f cannot be enclosed there
+        auto enclose = [&](double lo, double hi)
+        {
+            try
+            {
+                return f(interval_t(lo, hi)).inf();
+            }
+            catch (const std::domain_error &)
+            {
+                return -infinity;
+            }
+        };
+
+        certify(a);
+        certify(b);
+        queue.push({a, b, enclose(a, b)});
+
+        // Splits a box and applies the pruning tests to both halves. Returns the
+        // surviving children; point boxes on the domain boundary go to `points`.
+        auto branch = [&](const optimizer_box &box, std::vector<optimizer_box> &children, std::vector<optimizer_box> &points)
+        {
+            double m = box.lo + (box.hi - box.lo) / 2;
+            const optimizer_box halves[2] = {{box.lo, m, 0.0}, {m, box.hi, 0.0}};
+
+            for (const optimizer_box &half : halves)
+            {
+                double lower = enclose(half.lo, half.hi);
+                if (lower > incumbent.load(std::memory_order_relaxed))
+                {
+                    continue;
+                }
+
+                bool at_a = half.lo == a;
+                bool at_b = half.hi == b;
+
+                try
+                {
+                    // monotonicity: f' != 0 on the box, so the only possible minimizer
+                    // is an endpoint of the domain
+                    interval_t d = df(interval_t(half.lo, half.hi));
+                    if (!d.has_zero())
+                    {
+                        if (d.is_positive() && at_a)
+                        {
+                            points.push_back({a, a, enclose(a, a)});
+                        }
+                        if (d.is_negative() && at_b)
+                        {
+                            points.push_back({b, b, enclose(b, b)});
+                        }
+                        continue;
+                    }
+
+                    // concavity: f'' < 0 on the box rules out interior minimizers
+                    interval_t h = d2f(interval_t(half.lo, half.hi));
+                    if (h.is_negative())
+                    {
+                        if (at_a)
+                        {
+                            points.push_back({a, a, enclose(a, a)});
+                        }
+                        if (at_b)
+                        {
+                            points.push_back({b, b, enclose(b, b)});
+                        }
+                        continue;
+                    }
+                }
+                catch (const std::domain_error &)
+                {
+                }
+
+                // midpoint evaluation at double speed; certified only if it improves
+                double mid = half.lo + (half.hi - half.lo) / 2;
+                if (fp(mid) < incumbent.load(std::memory_order_relaxed))
+                {
+                    certify(mid);
+                }
+
+                children.push_back({half.lo, half.hi, lower});
+            }
+        };
+
+        auto worker = [&]()
+        {
+            std::vector<optimizer_box> children;
+            std::vector<optimizer_box> points;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                cv.wait(lock, [&] { return !queue.empty() || active == 0; });
+                if (queue.empty())
+                {
+                    break;
+                }
+
+                optimizer_box box = queue.top();
+                queue.pop();
+
+                if (box.f_lower > incumbent.load(std::memory_order_relaxed))
+                {
+                    continue;
+                }
+
+                if (box.hi - box.lo <= options.tolerance || processed >= options.max_boxes)
+                {
+                    candidates.push_back(box);
+                    continue;
+                }
+
+                ++processed;
+                ++active;
+                lock.unlock();
+
+                children.clear();
+                points.clear();
+                std::exception_ptr failure;
+                try
+                {
+                    branch(box, children, points);
+                }
+                catch (...)
+                {
+                    failure = std::current_exception();
+                }
+
+                lock.lock();
+                --active;
+                if (failure && !error)
+                {
+                    error = failure;
+                }
+                if (error)
+                {
+                    // drain: the others stop once their current box is done
+                    queue = {};
+                    break;
+                }
+                for (const optimizer_box &child : children)
+                {
+                    queue.push(child);
+                }
+                candidates.insert(candidates.end(), points.begin(), points.end());
+                cv.notify_all();
+            }
+            cv.notify_all();
+        };
+
+        unsigned n = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < n; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        for (std::thread &t : threads)
+        {
+            t.join();
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        double best = incumbent.load();
+        optimizer_result result{infinity, best, minimizer, {}, processed};
+
+        for (const optimizer_box &box : candidates)
+        {
+            if (box.f_lower <= best)
+            {
+                result.lower_bound = std::min(result.lower_bound, box.f_lower);
+                result.boxes.push_back(box);
+            }
+        }
+        result.lower_bound = std::min(result.lower_bound, best);
+
+        std::sort(result.boxes.begin(), result.boxes.end(),
+                  [](const optimizer_box &x, const optimizer_box &y) { return x.lo < y.lo; });
+
+        return result;
+    }
+} // namespace flib
@@ -1,9 +1,49 @@
 #pragma once
 #include "mpfr.h"
 #include <iostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace flib
 {
+    //----------------------------------------------------------------------------------------
+    // precision-independent kernels, compiled once in src/interval.cpp.
+    // Temporaries take the precision of the result operand.
+    //----------------------------------------------------------------------------------------
+
+    namespace detail
+    {
+        // [rl, ru] = [al, au] * [bl, bu]
+        void mul(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu);
+
+        // [rl, ru] = [al, au] / [bl, bu], 0 not in [bl, bu]
+        void div(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu);
+
+        // "[ l , u ]" with the bounds rounded outward
+        void print(std::ostream &os, mpfr_srcptr l, mpfr_srcptr u, int digits);
+
+        // [rl, ru] = [al, au] * [bl, bu] + [cl, cu], one rounding per bound
+        void fma(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu,
+                 mpfr_srcptr cl, mpfr_srcptr cu);
+
+        // [rl, ru] = sum_i [al_i, au_i] * [bl_i, bu_i], one rounding per bound
+        void dot(mpfr_ptr rl, mpfr_ptr ru, const mpfr_ptr *al, const mpfr_ptr *au, const mpfr_ptr *bl,
+                 const mpfr_ptr *bu, std::size_t n);
+
+        // [rl, ru] = sum_i [l_i, u_i], one rounding per bound
+        void sum(mpfr_ptr rl, mpfr_ptr ru, const mpfr_ptr *l, const mpfr_ptr *u, std::size_t n);
+
+        // [rl, ru] = sin([l, u]), or cos([l, u]) when cosine is set
+        void sin_cos(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr l, mpfr_srcptr u, bool cosine);
+
+        // [rl, ru] = tan([l, u]); false if [l, u] holds a pole
+        bool tangent(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr l, mpfr_srcptr u);
+
+        // [rl, ru] = [al, au] ^ [bl, bu], al > 0
+        void power(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu);
+    } // namespace detail
+
     template <class T, size_t Prec>
     class interval
     {
@@ -11,542 +51,1012 @@ namespace flib
         mpfr_t l;
         mpfr_t u;
 
-    public:
+        // monotone fast path: [f(l) rounded down, f(u) rounded up]
+        template <int (*F)(mpfr_ptr, mpfr_srcptr, mpfr_rnd_t)>
+        static interval increasing(const interval &x)
+        {
+            mpfr_t lb, ub;
+            mpfr_inits2(Prec, lb, ub, NULL);
 
+            F(lb, x.l, MPFR_RNDD);
+            F(ub, x.u, MPFR_RNDU);
 
-        interval()
-        {
-            mpfr_init_set_d(l, 0.0, MPFR_RNDD);
-            mpfr_init_set_d(u, 0.0, MPFR_RNDU);
-        }
+            interval<T, Prec> r(lb, ub);
 
-         interval(T a, T b)
-        {
-            if (mpfr_cmp(a, b) > 0)
-            {
-                throw std::invalid_argument("Invalid interval: lower bound is greater than upper bound");
-            }
-            mpfr_init2(l, Prec);
-            mpfr_init2(u, Prec);
-
-            mpfr_set(l, a, MPFR_RNDD);
-            mpfr_set(u, b, MPFR_RNDU);
+            mpfr_clears(lb, ub, NULL);
+
+            return r;
         }
 
+        static interval periodic(const interval &x, bool cosine);
 
-        interval( interval const& iv )
-        {
-          mpfr_init2( l, Prec );
-          mpfr_init2( u, Prec );
-          mpfr_set( l, iv.l, MPFR_RNDD );
-          mpfr_set( u, iv.u, MPFR_RNDU );
-        }
+        // alpha - iv and alpha / iv, behind the friend operators
+        static interval reverse_sub(const T &a, const interval &iv);
 
-        interval &operator=( interval const& iv)
-        {
-            if (this != &iv)
-            {
-                mpfr_set(l, iv.l, MPFR_RNDD);
-                mpfr_set(u, iv.u, MPFR_RNDU);
-            }
-            return *this;
-        }
+        static interval reverse_div(const T &a, const interval &iv);
 
-        ~interval()
-        {
-            mpfr_clear(l);
-            mpfr_clear(u);
-        }
+        void print(std::ostream &os) const;
+
+    public:
+        interval();
+
+        interval(T a, T b);
+
+        interval(double a, double b);
+
+        interval( interval const& iv );
+
+        interval &operator=( interval const& iv);
+
+        ~interval();
 
         //---------------------------------------
         // Lower bound
         //---------------------------------------
 
-        interval lower()
-        {
-            mpfr_t r;
-            mpfr_init2(r, Prec);
-
-            interval<T, Prec> result(this->l, this->l);
+        interval lower();
 
-            mpfr_clear(r);
+        //---------------------------------------
+        // Lower bound as a double, rounded down
+        //---------------------------------------
 
-            return result;
-        }
+        double inf() const;
 
         //---------------------------------------
         // Upper bound
         //---------------------------------------
 
-        interval upper()
-        {
-            mpfr_t r;
-            mpfr_init2(r, Prec);
+        interval upper();
 
-            interval<T, Prec> result(this->u, this->u);
-
-            mpfr_clear(r);
+        //---------------------------------------
+        // Upper bound as a double, rounded up
+        //---------------------------------------
 
-            return result;
-        }
+        double sup() const;
 
         //---------------------------------------
         // Returns the magnitude of the interval
         //---------------------------------------
 
-        interval width()
-        {
-            mpfr_t r;
-            mpfr_init2(r, Prec);
+        interval width();
 
-            mpfr_sub(r, u, l, MPFR_RNDN);
+        //---------------------------------------
+        // Returns the norm of the interval
+        //---------------------------------------
 
-            interval<T, Prec> result(r, r);
+        interval norm();
 
-            mpfr_clear(r);
+        //---------------------------------------
+        // Returns the mid point of the interval
+        //---------------------------------------
 
-            return result;
-        }
+        interval mid();
 
         //---------------------------------------
-        // Returns the norm of the interval
+        // [a , b] + [c , d] = [a+c, b+d]
         //---------------------------------------
 
-        interval norm()
-        {
-            mpfr_t r;
-            mpfr_t abs_l;
-            mpfr_t abs_u;
-
-            mpfr_inits2(Prec, r, abs_l, abs_u, NULL);
+        interval operator+(const interval &iv) const;
 
-            mpfr_abs(abs_l, l, MPFR_RNDD);
-            mpfr_abs(abs_u, u, MPFR_RNDU);
+        //---------------------------------------
+        // [a , b] + alpha = [a+alpha, b+alpha]
+        //---------------------------------------
 
-            mpfr_max(r, abs_l, abs_u, MPFR_RNDU);
-            interval<T, Prec> result(r, r);
+        interval operator+(const T &a) const;
 
-            mpfr_clears(r, abs_l, abs_u, NULL);
+        //-------------------------------------------
+        // alpha + [a , b]  = [alpha + a, alpha + b]
+        //-------------------------------------------
 
-            return result;
+        friend interval operator+(const T &a, const interval &iv)
+        {
+            return iv + a;
         }
 
         //---------------------------------------
-        // Returns the mid point of the interval
+        // [a , b] - alpha = [ a - alpha, b - alpha ]
         //---------------------------------------
 
-        interval mid()
-        {
-            mpfr_t r;
-
-            mpfr_init2(r, Prec);
+        interval operator-(const T &a) const;
 
-            mpfr_add(r, this->l, this->u, MPFR_RNDU);
-            mpfr_div_ui(r, r, 2, MPFR_RNDN);
+        //--------------------------------------------
+        // alpha - [a , b]  = [alpha - a, alpha - b]
+        //--------------------------------------------
 
-            interval<T, Prec> result(r, r);
+        friend interval operator-(const T &a, const interval &iv)
+        {
+            return reverse_sub(a, iv);
+        }
 
-            mpfr_clear(r);
+        //---------------------------------------
+        // [a , b] - [c , d] = [a-d, b-c]
+        //---------------------------------------
 
-            return result;
-        }
+        interval operator-(const interval &iv) const;
 
         //---------------------------------------
-        // [a , b] + [c , d] = [a+c, b+d]
+        // - [c , d] = [-d, -c]
         //---------------------------------------
 
-        interval operator+(const interval &iv) const
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        interval operator-() const;
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+        //----------------------------------------------------------
+        // [a , b] * [c , d] = [min A, max A], A = {ac, ad, bc, bd}
+        //----------------------------------------------------------
 
-            mpfr_add(result_l, l, iv.l, MPFR_RNDD);
-            mpfr_add(result_u, u, iv.u, MPFR_RNDU);
+        interval operator*(const interval &iv) const;
 
-            interval<T, Prec> r(result_l, result_u);
+        //----------------------------------------------------------
+        //  [a , b] * alpha  = [alpha * a , alpha * b]
+        //----------------------------------------------------------
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        interval operator*(const T &a) const;
 
-            return r;
+        friend interval operator*(const T &a, const interval &iv)
+        {
+            return iv * a;
         }
 
-        //---------------------------------------
-        // [a , b] + alpha = [a+alpha, b+alpha]
-        //---------------------------------------
+        //----------------------------------------------------------
+        //  [a , b] / alpha  = [ a / alpha, b / alpha ]
+        //----------------------------------------------------------
 
-        interval operator+(const T &a) const
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        interval operator/(const T &a) const;
+
+        //----------------------------------------------------------
+        //  alpha / [a , b] = [ alpha / b , alpha / a ]
+        //----------------------------------------------------------
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+        friend interval operator/(const T &a, const interval &iv)
+        {
+            return reverse_div(a, iv);
+        }
 
-            mpfr_add(result_l, l, a, MPFR_RNDD);
-            mpfr_add(result_u, u, a, MPFR_RNDU);
+        //----------------------------------------------------------
+        // [a , b] / [c, d] =  [a , b] * ( 1 / [c, d] )
+        //----------------------------------------------------------
 
-            interval<T, Prec> r(result_l, result_u);
+        interval operator/(const interval &iv) const;
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        //------------------------------------------------
+        // prints as many digits as Prec bits carry,
+        // rounding the bounds outward
+        //------------------------------------------------
 
-            return r;
+        friend std::ostream &operator<<(std::ostream &os, const interval &iv)
+        {
+            iv.print(os);
+            return os;
         }
 
-        //-------------------------------------------
-        // alpha + [a , b]  = [alpha + a, alpha + b]
-        //-------------------------------------------
+        //------------------------------------------------
+        // Intersection
+        //------------------------------------------------
 
-        friend interval operator+(const T &a, const interval &iv)
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        static interval intersection(const interval &a, const interval &b);
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+        //------------------------------------------------
+        // has zero
+        //------------------------------------------------
 
-            mpfr_add(result_l, a, iv.l, MPFR_RNDD);
-            mpfr_add(result_u, a, iv.u, MPFR_RNDU);
+        bool has_zero() const;
 
-            interval<T, Prec> r(result_l, result_u);
+        //------------------------------------------------
+        // every element > 0 / every element < 0, tested
+        // on the exact bounds (inf() and sup() may round
+        // a tiny bound to zero)
+        //------------------------------------------------
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        bool is_positive() const;
 
-            return r;
-        }
+        bool is_negative() const;
 
-        //---------------------------------------
-        // [a , b] - alpha = [ a - alpha, b - alpha ]
-        //---------------------------------------
+        //------------------------------------------------
+        // fused kernels: exact products, a single
+        // directed rounding per bound
+        //------------------------------------------------
 
-        interval operator-(const T &a) const
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        // a * b + c
+        static interval fma(const interval &a, const interval &b, const interval &c);
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+        // sum_i a[i] * b[i]
+        static interval dot(std::span<const interval> a, std::span<const interval> b);
 
-            mpfr_sub(result_l, l, a, MPFR_RNDD);
-            mpfr_sub(result_u, u, a, MPFR_RNDU);
+        // sum_i x[i]
+        static interval sum(std::span<const interval> x);
 
-            interval<T, Prec> r(result_l, result_u);
+        //------------------------------------------------
+        // functions
+        //------------------------------------------------
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        static interval exp(const interval &x);
 
-            return r;
-        }
+        static interval sqrt(const interval &x);
 
-        //--------------------------------------------
-        // alpha - [a , b]  = [alpha - a, alpha - b]
-        //--------------------------------------------
+        static interval log(const interval &x);
 
-        friend interval operator-(const T &a, const interval &iv)
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        static interval atan(const interval &x);
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+        static interval sinh(const interval &x);
 
-            mpfr_add(result_l, a, (-iv).l, MPFR_RNDD);
-            mpfr_add(result_u, a, (-iv).u, MPFR_RNDU);
+        static interval tanh(const interval &x);
 
-            interval<T, Prec> r(result_l, result_u);
+        // extrema found by range reduction modulo pi/2
+        static interval sin(const interval &x);
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        static interval cos(const interval &x);
 
-            return r;
-        }
+        static interval tan(const interval &x);
 
-        //---------------------------------------
-        // [a , b] - [c , d] = [a-d, b-c]
-        //---------------------------------------
+        // decreasing on x <= 0, increasing on x >= 0
+        static interval cosh(const interval &x);
 
-        interval operator-(const interval &iv) const
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        // x^k, integer k
+        static interval x_pwr_k(const interval &x, int k);
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+        // x^y, x > 0
+        static interval pow(const interval &x, const interval &y);
+    };
 
-            mpfr_sub(result_l, l, iv.u, MPFR_RNDD);
-            mpfr_sub(result_u, u, iv.l, MPFR_RNDU);
+    //----------------------------------------------------------------------------------------
+    // member definitions, out of the class so that they are not inline: the extern template
+    // declarations below keep consumers from instantiating them for the precisions in flib
+    //----------------------------------------------------------------------------------------
 
-            interval<T, Prec> r(result_l, result_u);
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::periodic(const interval &x, bool cosine)
+    {
+        mpfr_t lb, ub;
+        mpfr_inits2(Prec, lb, ub, NULL);
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        detail::sin_cos(lb, ub, x.l, x.u, cosine);
 
-            return r;
-        }
+        interval<T, Prec> r(lb, ub);
 
-        //---------------------------------------
-        // - [c , d] = [-d, -c]
-        //---------------------------------------
+        mpfr_clears(lb, ub, NULL);
 
-        interval operator-() const
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
+        return r;
+    }
 
-            mpfr_init2(result_l, Prec);
-            mpfr_init2(result_u, Prec);
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::reverse_sub(const T &a, const interval &iv)
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
 
-            mpfr_neg(result_l, u, MPFR_RNDD);
-            mpfr_neg(result_u, l, MPFR_RNDU);
+        mpfr_init2(result_l, Prec);
+        mpfr_init2(result_u, Prec);
 
-            interval<T, Prec> r(result_l, result_u);
+        mpfr_add(result_l, a, (-iv).l, MPFR_RNDD);
+        mpfr_add(result_u, a, (-iv).u, MPFR_RNDU);
 
-            mpfr_clear(result_l);
-            mpfr_clear(result_u);
+        interval<T, Prec> r(result_l, result_u);
 
-            return r;
-        }
+        mpfr_clear(result_l);
+        mpfr_clear(result_u);
 
-        //----------------------------------------------------------
-        // [a , b] * [c , d] = [min A, max A], A = {ac, ad, bc, bd}
-        //----------------------------------------------------------
+        return r;
+    }
 
-        interval operator*(const interval &iv) const
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::reverse_div(const T &a, const interval &iv)
+    {
+        int sign_l = mpfr_sgn(iv.l);
+        int sign_u = mpfr_sgn(iv.u);
+
+        if (sign_l * sign_u <= 0)
         {
-            mpfr_t p1, p2, p3, p4;
-            mpfr_t result_l;
-            mpfr_t result_u;
-            mpfr_inits2(Prec, p1, p2, p3, p4, result_l, result_u, NULL);
+            throw std::domain_error("Division by an interval containing zero is undefined");
+        }
 
-            mpfr_mul(p1, l, iv.l, MPFR_RNDD);
-            mpfr_mul(p2, l, iv.u, MPFR_RNDD);
-            mpfr_mul(p3, u, iv.l, MPFR_RNDU);
-            mpfr_mul(p4, u, iv.u, MPFR_RNDU);
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
 
-            mpfr_min(result_l, p1, p2, MPFR_RNDD);
-            mpfr_min(result_l, result_l, p3, MPFR_RNDD);
-            mpfr_min(result_l, result_l, p4, MPFR_RNDD);
+        mpfr_div(result_l, a, iv.u, MPFR_RNDD);
+        mpfr_div(result_u, a, iv.l, MPFR_RNDU);
 
-            mpfr_max(result_u, p1, p2, MPFR_RNDU);
-            mpfr_max(result_u, result_u, p3, MPFR_RNDU);
-            mpfr_max(result_u, result_u, p4, MPFR_RNDU);
+        interval<T, Prec> r(result_l, result_u);
 
-            interval<T, Prec> r(result_l, result_u);
+        mpfr_clears(result_l, result_u, NULL);
 
-            mpfr_clears(p1, p2, p3, p4, result_l, result_u, NULL);
+        return r;
+    }
 
-            return r;
-        }
+    template <class T, size_t Prec>
+    void interval<T, Prec>::print(std::ostream &os) const
+    {
+        constexpr int digits = static_cast<int>(Prec * 30103 / 100000) + 1;
 
-        //----------------------------------------------------------
-        //  [a , b] * alpha  = [alpha * a , alpha * b]
-        //----------------------------------------------------------
+        detail::print(os, l, u, digits);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec>::interval()
+    {
+        mpfr_init_set_d(l, 0.0, MPFR_RNDD);
+        mpfr_init_set_d(u, 0.0, MPFR_RNDU);
+    }
 
-        interval operator*(const T &a) const
+    template <class T, size_t Prec>
+    interval<T, Prec>::interval(T a, T b)
+    {
+        if (mpfr_cmp(a, b) > 0)
         {
-            mpfr_t result_l;
-            mpfr_t result_u;
-            mpfr_inits2(Prec, result_l, result_u, NULL);
+            throw std::invalid_argument("Invalid interval: lower bound is greater than upper bound");
+        }
+        mpfr_init2(l, Prec);
+        mpfr_init2(u, Prec);
+
+        mpfr_set(l, a, MPFR_RNDD);
+        mpfr_set(u, b, MPFR_RNDU);
+    }
 
-            mpfr_mul(result_l, l, a, MPFR_RNDD);
-            mpfr_mul(result_u, u, a, MPFR_RNDU);
+    template <class T, size_t Prec>
+    interval<T, Prec>::interval(double a, double b)
+    {
+        if (a > b)
+        {
+            throw std::invalid_argument("Invalid interval: lower bound is greater than upper bound");
+        }
+        mpfr_init2(l, Prec);
+        mpfr_init2(u, Prec);
 
-            interval<T, Prec> r(result_l, result_u);
+        mpfr_set_d(l, a, MPFR_RNDD);
+        mpfr_set_d(u, b, MPFR_RNDU);
+    }
 
-            mpfr_clears(result_l, result_u, NULL);
+    template <class T, size_t Prec>
+    interval<T, Prec>::interval( interval const& iv )
+    {
+      mpfr_init2( l, Prec );
+      mpfr_init2( u, Prec );
+      mpfr_set( l, iv.l, MPFR_RNDD );
+      mpfr_set( u, iv.u, MPFR_RNDU );
+    }
 
-            return r;
+    template <class T, size_t Prec>
+    interval<T, Prec> &interval<T, Prec>::operator=( interval const& iv)
+    {
+        if (this != &iv)
+        {
+            mpfr_set(l, iv.l, MPFR_RNDD);
+            mpfr_set(u, iv.u, MPFR_RNDU);
         }
+        return *this;
+    }
 
-        friend interval operator*(const T &a, const interval &iv)
-        {
-            mpfr_t result_l;
-            mpfr_t result_u;
-            mpfr_inits2(Prec, result_l, result_u, NULL);
+    template <class T, size_t Prec>
+    interval<T, Prec>::~interval()
+    {
+        mpfr_clear(l);
+        mpfr_clear(u);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::lower()
+    {
+        mpfr_t r;
+        mpfr_init2(r, Prec);
 
-            mpfr_mul(result_l, iv.l, a, MPFR_RNDD);
-            mpfr_mul(result_u, iv.u, a, MPFR_RNDU);
+        interval<T, Prec> result(this->l, this->l);
 
-            interval<T, Prec> r(result_l, result_u);
+        mpfr_clear(r);
 
-            mpfr_clears(result_l, result_u, NULL);
+        return result;
+    }
 
-            return r;
-        }
+    template <class T, size_t Prec>
+    double interval<T, Prec>::inf() const
+    {
+        return mpfr_get_d(l, MPFR_RNDD);
+    }
 
-        //----------------------------------------------------------
-        //  [a , b] / alpha  = [ a / alpha, b / alpha ]
-        //----------------------------------------------------------
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::upper()
+    {
+        mpfr_t r;
+        mpfr_init2(r, Prec);
 
-        interval operator/(const T &a) const
-        {
+        interval<T, Prec> result(this->u, this->u);
+
+        mpfr_clear(r);
+
+        return result;
+    }
 
-            if (a == 0)
-            {
-                throw std::invalid_argument("Division by zero is undefined");
-            }
+    template <class T, size_t Prec>
+    double interval<T, Prec>::sup() const
+    {
+        return mpfr_get_d(u, MPFR_RNDU);
+    }
 
-            mpfr_t result_l;
-            mpfr_t result_u;
-            mpfr_inits2(Prec, result_l, result_u, NULL);
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::width()
+    {
+        mpfr_t r;
+        mpfr_init2(r, Prec);
 
-            mpfr_div(result_l, l, a, MPFR_RNDD);
-            mpfr_div(result_u, u, a, MPFR_RNDU);
+        mpfr_sub(r, u, l, MPFR_RNDN);
 
-            interval<T, Prec> r(result_l, result_u);
+        interval<T, Prec> result(r, r);
 
-            mpfr_clears(result_l, result_u, NULL);
+        mpfr_clear(r);
 
-            return r;
-        }
+        return result;
+    }
 
-        //----------------------------------------------------------
-        //  alpha / [a , b] = [ alpha / b , alpha / a ]
-        //----------------------------------------------------------
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::norm()
+    {
+        mpfr_t r;
+        mpfr_t abs_l;
+        mpfr_t abs_u;
 
-        friend interval operator/(const T &a, const interval &iv)
+        mpfr_inits2(Prec, r, abs_l, abs_u, NULL);
+
+        mpfr_abs(abs_l, l, MPFR_RNDD);
+        mpfr_abs(abs_u, u, MPFR_RNDU);
+
+        mpfr_max(r, abs_l, abs_u, MPFR_RNDU);
+        interval<T, Prec> result(r, r);
+
+        mpfr_clears(r, abs_l, abs_u, NULL);
+
+        return result;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::mid()
+    {
+        mpfr_t r;
+
+        mpfr_init2(r, Prec);
+
+        mpfr_add(r, this->l, this->u, MPFR_RNDU);
+        mpfr_div_ui(r, r, 2, MPFR_RNDN);
+
+        interval<T, Prec> result(r, r);
+
+        mpfr_clear(r);
+
+        return result;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator+(const interval &iv) const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+
+        mpfr_init2(result_l, Prec);
+        mpfr_init2(result_u, Prec);
+
+        mpfr_add(result_l, l, iv.l, MPFR_RNDD);
+        mpfr_add(result_u, u, iv.u, MPFR_RNDU);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clear(result_l);
+        mpfr_clear(result_u);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator+(const T &a) const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+
+        mpfr_init2(result_l, Prec);
+        mpfr_init2(result_u, Prec);
+
+        mpfr_add(result_l, l, a, MPFR_RNDD);
+        mpfr_add(result_u, u, a, MPFR_RNDU);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clear(result_l);
+        mpfr_clear(result_u);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator-(const T &a) const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+
+        mpfr_init2(result_l, Prec);
+        mpfr_init2(result_u, Prec);
+
+        mpfr_sub(result_l, l, a, MPFR_RNDD);
+        mpfr_sub(result_u, u, a, MPFR_RNDU);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clear(result_l);
+        mpfr_clear(result_u);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator-(const interval &iv) const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+
+        mpfr_init2(result_l, Prec);
+        mpfr_init2(result_u, Prec);
+
+        mpfr_sub(result_l, l, iv.u, MPFR_RNDD);
+        mpfr_sub(result_u, u, iv.l, MPFR_RNDU);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clear(result_l);
+        mpfr_clear(result_u);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator-() const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+
+        mpfr_init2(result_l, Prec);
+        mpfr_init2(result_u, Prec);
+
+        mpfr_neg(result_l, u, MPFR_RNDD);
+        mpfr_neg(result_u, l, MPFR_RNDU);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clear(result_l);
+        mpfr_clear(result_u);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator*(const interval &iv) const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
+
+        detail::mul(result_l, result_u, l, u, iv.l, iv.u);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clears(result_l, result_u, NULL);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator*(const T &a) const
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
+
+        mpfr_mul(result_l, l, a, MPFR_RNDD);
+        mpfr_mul(result_u, u, a, MPFR_RNDU);
+
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clears(result_l, result_u, NULL);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator/(const T &a) const
+    {
+
+        if (mpfr_zero_p(a))
         {
-            int sign_l = mpfr_sgn(iv.l);
-            int sign_u = mpfr_sgn(iv.u);
+            throw std::invalid_argument("Division by zero is undefined");
+        }
 
-            if (sign_l * sign_u <= 0)
-            {
-                throw std::domain_error("Division by an interval containing zero is undefined");
-            }
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
 
-            mpfr_t result_l;
-            mpfr_t result_u;
-            mpfr_inits2(Prec, result_l, result_u, NULL);
+        mpfr_div(result_l, l, a, MPFR_RNDD);
+        mpfr_div(result_u, u, a, MPFR_RNDU);
 
-            mpfr_div(result_l, a, iv.u, MPFR_RNDD);
-            mpfr_div(result_u, a, iv.l, MPFR_RNDU);
+        interval<T, Prec> r(result_l, result_u);
 
-            interval<T, Prec> r(result_l, result_u);
+        mpfr_clears(result_l, result_u, NULL);
 
-            mpfr_clears(result_l, result_u, NULL);
+        return r;
+    }
 
-            return r;
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::operator/(const interval &iv) const
+    {
+
+        int sign_l = mpfr_sgn(iv.l);
+        int sign_u = mpfr_sgn(iv.u);
+
+        if (sign_l * sign_u <= 0)
+        {
+            throw std::domain_error("Division by an interval containing zero is undefined");
         }
 
-        //----------------------------------------------------------
-        // [a , b] / [c, d] =  [a , b] * ( 1 / [c, d] )
-        //----------------------------------------------------------
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
+
+        detail::div(result_l, result_u, l, u, iv.l, iv.u);
 
-        interval operator/(const interval &iv) const
+        interval<T, Prec> r(result_l, result_u);
+
+        mpfr_clears(result_l, result_u, NULL);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::intersection(const interval &a, const interval &b)
+    {
+        if (mpfr_cmp(b.u, a.l) < 0 || mpfr_cmp(a.u, b.l) < 0)
         {
+            throw std::domain_error("Empty intersection");
+        }
 
-            int sign_l = mpfr_sgn(iv.l);
-            int sign_u = mpfr_sgn(iv.u);
+        mpfr_t min, max;
+        mpfr_inits2(Prec, min, max, NULL);
 
-            if (sign_l * sign_u <= 0)
-            {
-                throw std::domain_error("Division by an interval containing zero is undefined");
-            }
+        mpfr_max(max, a.l, b.l, MPFR_RNDU);
+        mpfr_min(min, a.u, b.u, MPFR_RNDD);
 
-            mpfr_t p1, p2, p3, p4;
-            mpfr_t result_l;
-            mpfr_t result_u;
-            mpfr_t recip_l, recip_u;
+        interval<T, Prec> r(max, min);
 
-            mpfr_inits2(Prec, p1, p2, p3, p4, result_l, result_u, recip_l, recip_u, NULL);
+        mpfr_clears(min, max, NULL);
 
-            mpfr_ui_div(recip_l, 1, iv.u, MPFR_RNDD);
-            mpfr_ui_div(recip_u, 1, iv.l, MPFR_RNDU);
+        return r;
+    }
 
-            mpfr_mul(p1, l, recip_l, MPFR_RNDD);
-            mpfr_mul(p2, l, recip_u, MPFR_RNDD);
-            mpfr_mul(p3, u, recip_l, MPFR_RNDU);
-            mpfr_mul(p4, u, recip_u, MPFR_RNDU);
+    template <class T, size_t Prec>
+    bool interval<T, Prec>::has_zero() const
+    {
+        return mpfr_sgn(l) <= 0 && mpfr_sgn(u) >= 0;
+    }
+
+    template <class T, size_t Prec>
+    bool interval<T, Prec>::is_positive() const
+    {
+        return mpfr_sgn(l) > 0;
+    }
+
+    template <class T, size_t Prec>
+    bool interval<T, Prec>::is_negative() const
+    {
+        return mpfr_sgn(u) < 0;
+    }
 
-            mpfr_min(result_l, p1, p2, MPFR_RNDD);
-            mpfr_min(result_l, result_l, p3, MPFR_RNDD);
-            mpfr_min(result_l, result_l, p4, MPFR_RNDD);
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::fma(const interval &a, const interval &b, const interval &c)
+    {
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
 
-            mpfr_max(result_u, p1, p2, MPFR_RNDU);
-            mpfr_max(result_u, result_u, p3, MPFR_RNDU);
-            mpfr_max(result_u, result_u, p4, MPFR_RNDU);
+        detail::fma(result_l, result_u, a.l, a.u, b.l, b.u, c.l, c.u);
 
-            interval<T, Prec> r(result_l, result_u);
+        interval<T, Prec> r(result_l, result_u);
 
-            mpfr_clears(p1, p2, p3, p4, result_l, result_u, recip_l, recip_u, NULL);
+        mpfr_clears(result_l, result_u, NULL);
 
-            return r;
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::dot(std::span<const interval> a, std::span<const interval> b)
+    {
+        if (a.size() != b.size())
+        {
+            throw std::invalid_argument("Dot product of spans with different sizes");
         }
 
-        friend std::ostream &operator<<(std::ostream &os, const interval &iv)
+        std::vector<mpfr_ptr> al(a.size()), au(a.size()), bl(b.size()), bu(b.size());
+        for (std::size_t i = 0; i < a.size(); ++i)
         {
-            char lb[Prec], ub[Prec];
-            mpfr_sprintf(lb, "%.310Re", iv.l);
-            mpfr_sprintf(ub, "%.310Re", iv.u);
-            os << "[ " << lb << " , " << ub << " ]";
-            return os;
+            al[i] = const_cast<mpfr_ptr>(a[i].l);
+            au[i] = const_cast<mpfr_ptr>(a[i].u);
+            bl[i] = const_cast<mpfr_ptr>(b[i].l);
+            bu[i] = const_cast<mpfr_ptr>(b[i].u);
         }
 
-        //------------------------------------------------
-        // Intersection
-        //------------------------------------------------
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
+
+        detail::dot(result_l, result_u, al.data(), au.data(), bl.data(), bu.data(), a.size());
+
+        interval<T, Prec> r(result_l, result_u);
 
-        static interval intersection(const interval &a, const interval &b)
+        mpfr_clears(result_l, result_u, NULL);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::sum(std::span<const interval> x)
+    {
+        std::vector<mpfr_ptr> xl(x.size()), xu(x.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
         {
-            if (mpfr_cmp(b.u, a.l) < 0 || mpfr_cmp(a.u, b.l) < 0)
-            {
-                throw std::domain_error("Empty intersection");
-            }
+            xl[i] = const_cast<mpfr_ptr>(x[i].l);
+            xu[i] = const_cast<mpfr_ptr>(x[i].u);
+        }
 
-            mpfr_t min, max;
-            mpfr_inits2(Prec, min, max, NULL);
+        mpfr_t result_l;
+        mpfr_t result_u;
+        mpfr_inits2(Prec, result_l, result_u, NULL);
 
-            mpfr_max(max, a.l, b.l, MPFR_RNDU);
-            mpfr_min(min, a.u, b.u, MPFR_RNDD);
+        detail::sum(result_l, result_u, xl.data(), xu.data(), x.size());
 
-            interval<T, Prec> r(max, min);
+        interval<T, Prec> r(result_l, result_u);
 
-            return r;
+        mpfr_clears(result_l, result_u, NULL);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::exp(const interval &x)
+    {
+        return increasing<mpfr_exp>(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::sqrt(const interval &x)
+    {
+        if (mpfr_sgn(x.l) < 0 || mpfr_sgn(x.u) < 0)
+        {
+            throw std::domain_error("The interval has negative values");
         }
 
-        // has zero
-        //
-        //--------
+        return increasing<mpfr_sqrt>(x);
+    }
 
-        //------------------------------------------------
-        // functions
-        //------------------------------------------------
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::log(const interval &x)
+    {
+        if (mpfr_sgn(x.l) <= 0)
+        {
+            throw std::domain_error("The interval has non-positive values");
+        }
 
-        static interval exp(const interval &x)
+        return increasing<mpfr_log>(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::atan(const interval &x)
+    {
+        return increasing<mpfr_atan>(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::sinh(const interval &x)
+    {
+        return increasing<mpfr_sinh>(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::tanh(const interval &x)
+    {
+        return increasing<mpfr_tanh>(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::sin(const interval &x)
+    {
+        return periodic(x, false);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::cos(const interval &x)
+    {
+        return periodic(x, true);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::tan(const interval &x)
+    {
+        mpfr_t lb, ub;
+        mpfr_inits2(Prec, lb, ub, NULL);
+
+        if (!detail::tangent(lb, ub, x.l, x.u))
         {
-            mpfr_t lb, ub;
-            mpfr_inits2(Prec, lb, ub, NULL);
+            mpfr_clears(lb, ub, NULL);
+            throw std::domain_error("tan is undefined on an interval holding an odd multiple of pi/2");
+        }
 
-            mpfr_exp(lb, x.l, MPFR_RNDD);
-            mpfr_exp(ub, x.u, MPFR_RNDU);
+        interval<T, Prec> r(lb, ub);
 
-            interval<T, Prec> r(lb, ub);
+        mpfr_clears(lb, ub, NULL);
 
-            return r;
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::cosh(const interval &x)
+    {
+        if (mpfr_sgn(x.l) >= 0)
+        {
+            return increasing<mpfr_cosh>(x);
         }
 
-        static interval sqrt(const interval &x)
+        mpfr_t lb, ub;
+        mpfr_inits2(Prec, lb, ub, NULL);
+
+        if (mpfr_sgn(x.u) <= 0)
+        {
+            mpfr_cosh(lb, x.u, MPFR_RNDD);
+            mpfr_cosh(ub, x.l, MPFR_RNDU);
+        }
+        else
         {
-            if (mpfr_sgn(x.l) < 0 || mpfr_sgn(x.u) < 0)
-            {
-                throw std::domain_error("The interval has negative values");
-            }
+            mpfr_set_ui(lb, 1, MPFR_RNDD);
+            mpfr_cosh(ub, mpfr_cmpabs(x.l, x.u) >= 0 ? x.l : x.u, MPFR_RNDU);
+        }
 
-            mpfr_t lb, ub;
-            mpfr_inits2(Prec, lb, ub, NULL);
+        interval<T, Prec> r(lb, ub);
 
-            mpfr_sqrt(lb, x.l, MPFR_RNDD);
-            mpfr_sqrt(ub, x.u, MPFR_RNDU);
+        mpfr_clears(lb, ub, NULL);
 
-            interval<T, Prec> r(lb, ub);
+        return r;
+    }
 
-            return r;
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::x_pwr_k(const interval &x, int k)
+    {
+        if (k < 0 && x.has_zero())
+        {
+            throw std::domain_error("Division by an interval containing zero is undefined");
         }
-    };
+
+        mpfr_t lb, ub;
+        mpfr_inits2(Prec, lb, ub, NULL);
+
+        bool odd = k % 2 != 0;
+        if (!odd && k > 0 && x.has_zero())
+        {
+            mpfr_set_ui(lb, 0, MPFR_RNDD);
+            mpfr_pow_si(ub, mpfr_cmpabs(x.l, x.u) >= 0 ? x.l : x.u, k, MPFR_RNDU);
+        }
+        else if (odd ? k > 0 : (k > 0) == (mpfr_sgn(x.l) >= 0))
+        {
+            mpfr_pow_si(lb, x.l, k, MPFR_RNDD);
+            mpfr_pow_si(ub, x.u, k, MPFR_RNDU);
+        }
+        else
+        {
+            mpfr_pow_si(lb, x.u, k, MPFR_RNDD);
+            mpfr_pow_si(ub, x.l, k, MPFR_RNDU);
+        }
+
+        interval<T, Prec> r(lb, ub);
+
+        mpfr_clears(lb, ub, NULL);
+
+        return r;
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> interval<T, Prec>::pow(const interval &x, const interval &y)
+    {
+        if (mpfr_sgn(x.l) <= 0)
+        {
+            throw std::domain_error("The base interval has non-positive values");
+        }
+
+        mpfr_t lb, ub;
+        mpfr_inits2(Prec, lb, ub, NULL);
+
+        detail::power(lb, ub, x.l, x.u, y.l, y.u);
+
+        interval<T, Prec> r(lb, ub);
+
+        mpfr_clears(lb, ub, NULL);
+
+        return r;
+    }
+
+    //----------------------------------------------------------------------------------------
+    // free functions, so that generic code such as my_function(x) also takes intervals
+    //----------------------------------------------------------------------------------------
+
+    template <class T, size_t Prec>
+    interval<T, Prec> exp(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::exp(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> sqrt(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::sqrt(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> log(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::log(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> sin(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::sin(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> cos(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::cos(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> tan(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::tan(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> atan(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::atan(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> sinh(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::sinh(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> cosh(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::cosh(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> tanh(const interval<T, Prec> &x)
+    {
+        return interval<T, Prec>::tanh(x);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> x_pwr_k(const interval<T, Prec> &x, int k)
+    {
+        return interval<T, Prec>::x_pwr_k(x, k);
+    }
+
+    template <class T, size_t Prec>
+    interval<T, Prec> pow(const interval<T, Prec> &x, const interval<T, Prec> &y)
+    {
+        return interval<T, Prec>::pow(x, y);
+    }
+
+    //----------------------------------------------------------------------------------------
+    // instantiated once in the flib library
+    //----------------------------------------------------------------------------------------
+
+    extern template class interval<mpfr_t, 53>;
+    extern template class interval<mpfr_t, 113>;
+    extern template class interval<mpfr_t, 256>;
+    extern template class interval<mpfr_t, 512>;
+    extern template class interval<mpfr_t, 1024>;
 
 } // namespace
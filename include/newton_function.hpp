@@ -1,28 +1,180 @@
 #pragma once
+#include <concepts>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 #include "autodiff.hpp"
 #include "elementary_functions.hpp"
 
 //----------------------------------------------------------------------------------------
-// método de Newton com heranca
+// método de Newton com despacho estático
+//
+// Qualquer chamável f(T) -> T serve como função; o solver é instanciado para o tipo
+// concreto de f, que pode ser inlinado no laço. Um chamável pode ainda oferecer uma
+// sobrecarga em lote f(std::span<const double>, std::span<fdh>) para amortizar o custo
+// por chamada.
 //----------------------------------------------------------------------------------------
 
 namespace flib
 {
-    class newton_function
-    {
-    public:
-        virtual ~newton_function() {}
-        virtual fdh operator()(double x) = 0;
+    template <class F, class T>
+    concept newton_function = std::invocable<F &, T> && std::convertible_to<std::invoke_result_t<F &, T>, T>;
+
+    template <class F>
+    concept batch_newton_function = requires(F &f, std::span<const double> x, std::span<fdh> out) {
+        f(x, out);
+    };
+
+    // f(x, p) with a parameter vector p
+    template <class F>
+    concept parametric_function = requires(F &f, fdh x, std::span<const fdh> p) {
+        { f(x, p) } -> std::convertible_to<fdh>;
     };
 
-    class my_f : public newton_function
+    struct my_f
     {
-    public:
-        fdh operator()(double x) override
+        template <class T>
+        T operator()(T x) const
         {
-            fdh fdhx{x, 1, 0};
-            fdh r = my_function(fdhx);
-            return r;
+            return my_function(x);
         }
     };
+
+    //---------------------------------------
+    // out[i] = f( fdh{x[i], 1, 0} )
+    //---------------------------------------
+
+    template <class F>
+        requires newton_function<F, fdh> || batch_newton_function<F>
+    void evaluate(F &f, std::span<const double> x, std::span<fdh> out)
+    {
+        if (x.size() != out.size())
+        {
+            throw std::invalid_argument("Input and output spans have different sizes");
+        }
+
+        if constexpr (batch_newton_function<F>)
+        {
+            f(x, out);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                out[i] = f(fdh{x[i], 1, 0});
+            }
+        }
+    }
+
+    template <class F>
+        requires newton_function<F, fdh>
+    double newton(F &&f, double x, int iterations = 10)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            fdh fdhx = f(fdh{x, 1, 0});
+            x = x - fdhx.f / fdhx.d;
+        }
+
+        return x;
+    }
+
+    //---------------------------------------
+    // Newton on every x[i], in place
+    //---------------------------------------
+
+    template <class F>
+        requires newton_function<F, fdh> || batch_newton_function<F>
+    void newton(F &&f, std::span<double> x, int iterations = 10)
+    {
+        std::vector<fdh> r(x.size());
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            evaluate(f, std::span<const double>(x), std::span<fdh>(r));
+            for (std::size_t j = 0; j < x.size(); ++j)
+            {
+                x[j] = x[j] - r[j].f / r[j].d;
+            }
+        }
+    }
+
+    //---------------------------------------
+    // Newton on x -> f(x, p), p fixed
+    //---------------------------------------
+
+    template <class F>
+        requires parametric_function<F>
+    double newton(F &&f, double x, std::span<const double> p, int iterations = 10)
+    {
+        std::vector<fdh> q(p.size());
+        for (std::size_t k = 0; k < p.size(); ++k)
+        {
+            q[k] = fdh{p[k], 0, 0};
+        }
+
+        return newton([&](fdh v) -> fdh { return f(v, std::span<const fdh>(q)); }, x, iterations);
+    }
+
+    //----------------------------------------------------------------------------------------
+    // sensibilidade da raiz pelo teorema da função implícita
+    //
+    //   f(x*(p), p) = 0  =>  dx*/dp_k = - (df/dx)^-1 df/dp_k
+    //
+    // Avaliado uma vez na raiz convergida, sem derivar através das iterações: uma
+    // avaliação para df/dx e uma por parâmetro para df/dp_k.
+    //----------------------------------------------------------------------------------------
+
+    template <class F>
+        requires parametric_function<F>
+    void root_sensitivity(F &&f, double root, std::span<const double> p, std::span<double> dxdp)
+    {
+        if (p.size() != dxdp.size())
+        {
+            throw std::invalid_argument("Input and output spans have different sizes");
+        }
+
+        std::vector<fdh> q(p.size());
+        for (std::size_t k = 0; k < p.size(); ++k)
+        {
+            q[k] = fdh{p[k], 0, 0};
+        }
+
+        fdh fx = f(fdh{root, 1, 0}, std::span<const fdh>(q));
+        if (fx.d == 0)
+        {
+            throw std::domain_error("Singular root: df/dx is zero");
+        }
+
+        for (std::size_t k = 0; k < p.size(); ++k)
+        {
+            q[k].d = 1;
+            fdh fp = f(fdh{root, 0, 0}, std::span<const fdh>(q));
+            q[k].d = 0;
+
+            dxdp[k] = -fp.d / fx.d;
+        }
+    }
+
+    //---------------------------------------
+    // batch: problem i has root roots[i] and
+    // parameters p[i*m, (i+1)*m), m = p.size() / roots.size()
+    //---------------------------------------
+
+    template <class F>
+        requires parametric_function<F>
+    void root_sensitivity(F &&f, std::span<const double> roots, std::span<const double> p, std::span<double> dxdp)
+    {
+        if (roots.empty() || p.size() % roots.size() != 0 || p.size() != dxdp.size())
+        {
+            throw std::invalid_argument("Parameter spans do not match the number of roots");
+        }
+
+        std::size_t m = p.size() / roots.size();
+        for (std::size_t i = 0; i < roots.size(); ++i)
+        {
+            root_sensitivity(f, roots[i], p.subspan(i * m, m), dxdp.subspan(i * m, m));
+        }
+    }
 } // namespace flib
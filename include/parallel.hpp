@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+// laço paralelo usado pelos modos em lote.
+//
+// As threads pegam índices de um contador atômico. A primeira exceção lançada por um
+// job é guardada, nenhum índice novo é distribuído e ela é relançada na thread que
+// chamou, depois do join.
+//----------------------------------------------------------------------------------------
+
+namespace flib::detail
+{
+    // job(i) for i in [0, n) on up to `threads` threads (0 = hardware_concurrency),
+    // the calling thread included
+    template <class Job>
+    void parallel_for(std::size_t n, unsigned threads, Job &&job)
+    {
+        std::atomic<std::size_t> next{0};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        auto worker = [&]()
+        {
+            for (std::size_t i = next++; i < n; i = next++)
+            {
+                try
+                {
+                    job(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> guard(error_mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    next = n;
+                }
+            }
+        };
+
+        unsigned count = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        count = static_cast<unsigned>(std::min<std::size_t>(count, n));
+
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < count; ++i)
+        {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &t : pool)
+        {
+            t.join();
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+} // namespace flib::detail
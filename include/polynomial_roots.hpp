@@ -0,0 +1,305 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "interval.hpp"
+#include "parallel.hpp"
+
+//----------------------------------------------------------------------------------------
+// raízes de polinômios pelo método de Aberth–Ehrlich.
+//
+// Todas as raízes são atualizadas simultaneamente (passo de Jacobi), com as partes real
+// e imaginária em vetores separados para que o laço O(n^2) vetorize. Ao final, cada
+// aproximação z_i recebe um raio de inclusão
+//
+//   r_i = n |p(z_i)| / |a_n prod_{j != i} (z_i - z_j)|
+//
+// calculado com aritmética intervalar. A união dos discos |z - z_i| <= r_i contém todas
+// as raízes, e um disco disjunto dos demais contém exatamente uma raiz.
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    struct aberth_options
+    {
+        int max_iterations = 200;
+        double tolerance = 1e-15;   // relative size of the last correction
+        unsigned threads = 0;       // batch only; 0 = std::thread::hardware_concurrency()
+    };
+
+    struct polynomial_roots
+    {
+        std::vector<std::complex<double>> roots;
+        std::vector<double> radius;    // a root lies within radius[i] of roots[i]
+        std::vector<bool> isolated;    // the disk of roots[i] holds exactly one root
+        int iterations;
+        bool converged;
+    };
+
+    namespace detail
+    {
+        template <size_t Prec>
+        struct complex_interval
+        {
+            interval<mpfr_t, Prec> re;
+            interval<mpfr_t, Prec> im;
+
+            complex_interval operator+(const complex_interval &z) const
+            {
+                return {re + z.re, im + z.im};
+            }
+
+            complex_interval operator-(const complex_interval &z) const
+            {
+                return {re - z.re, im - z.im};
+            }
+
+            complex_interval operator*(const complex_interval &z) const
+            {
+                return {re * z.re - im * z.im, re * z.im + im * z.re};
+            }
+
+            // |z|^2
+            interval<mpfr_t, Prec> norm() const
+            {
+                return re * re + im * im;
+            }
+
+            static complex_interval point(std::complex<double> z)
+            {
+                return {interval<mpfr_t, Prec>(z.real(), z.real()), interval<mpfr_t, Prec>(z.imag(), z.imag())};
+            }
+        };
+
+        //---------------------------------------
+        // p(z) and p'(z) by Horner; bound is
+        // sum |a_k| |z|^k, the scale of the
+        // rounding error in p
+        //---------------------------------------
+
+        inline void horner(std::span<const std::complex<double>> a, std::complex<double> z,
+                           std::complex<double> &p, std::complex<double> &dp, double &bound)
+        {
+            std::size_t n = a.size() - 1;
+            double r = std::abs(z);
+            p = a[n];
+            dp = 0;
+            bound = std::abs(a[n]);
+            for (std::size_t k = n; k-- > 0;)
+            {
+                dp = dp * z + p;
+                p = p * z + a[k];
+                bound = bound * r + std::abs(a[k]);
+            }
+        }
+
+        inline double next_up(double x)
+        {
+            return std::nextafter(x, std::numeric_limits<double>::infinity());
+        }
+    } // namespace detail
+
+    //----------------------------------------------------------------------------------------
+    // inclusion radii for approximations z of the roots of a[0] + a[1] z + ... + a[n] z^n
+    //----------------------------------------------------------------------------------------
+
+    template <size_t Prec>
+    void verify_roots(std::span<const std::complex<double>> a, polynomial_roots &r)
+    {
+        using complex_t = detail::complex_interval<Prec>;
+
+        std::size_t n = r.roots.size();
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        r.radius.assign(n, infinity);
+        r.isolated.assign(n, false);
+
+        complex_t leading = complex_t::point(a[n]);
+        interval<mpfr_t, Prec> degree2(static_cast<double>(n * n), static_cast<double>(n * n));
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            complex_t z = complex_t::point(r.roots[i]);
+
+            complex_t p = complex_t::point(a[n]);
+            for (std::size_t k = n; k-- > 0;)
+            {
+                p = p * z + complex_t::point(a[k]);
+            }
+
+            interval<mpfr_t, Prec> den = leading.norm();
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                if (j != i)
+                {
+                    den = den * (z - complex_t::point(r.roots[j])).norm();
+                }
+            }
+
+            if (den.inf() <= 0)
+            {
+                continue;
+            }
+
+            double r2 = ((degree2 * p.norm()) / den).sup();
+            r.radius[i] = detail::next_up(std::sqrt(r2));
+        }
+
+        // |z_i - z_j| in double is off by a few ulps; the margin keeps the test safe
+        constexpr double margin = 1 - 8 * std::numeric_limits<double>::epsilon();
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            bool alone = std::isfinite(r.radius[i]);
+            for (std::size_t j = 0; j < n && alone; ++j)
+            {
+                if (j != i && std::abs(r.roots[i] - r.roots[j]) * margin <= r.radius[i] + r.radius[j])
+                {
+                    alone = false;
+                }
+            }
+            r.isolated[i] = alone;
+        }
+    }
+
+    //----------------------------------------------------------------------------------------
+    // all roots of a[0] + a[1] z + ... + a[n] z^n
+    //----------------------------------------------------------------------------------------
+
+    template <size_t Prec = 113>
+    polynomial_roots aberth(std::span<const std::complex<double>> a, aberth_options options = {})
+    {
+        while (!a.empty() && a.back() == 0.0)
+        {
+            a = a.first(a.size() - 1);
+        }
+        if (a.size() < 2)
+        {
+            throw std::invalid_argument("The polynomial has no roots");
+        }
+
+        std::size_t n = a.size() - 1;
+
+        // start on a circle of radius (|a_0| / |a_n|)^(1/n), off the real axis
+        double radius = std::pow(std::abs(a[0]) / std::abs(a[n]), 1.0 / static_cast<double>(n));
+        if (!(radius > 0) || !std::isfinite(radius))
+        {
+            radius = 1;
+        }
+
+        std::vector<double> re(n), im(n);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            double angle = 2 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(n) + 0.4;
+            re[k] = radius * std::cos(angle);
+            im[k] = radius * std::sin(angle);
+        }
+
+        std::vector<double> step_re(n), step_im(n);
+        std::vector<bool> done(n, false);
+
+        polynomial_roots r{};
+        r.converged = false;
+
+        for (r.iterations = 0; r.iterations < options.max_iterations && !r.converged; ++r.iterations)
+        {
+            r.converged = true;
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                step_re[i] = 0;
+                step_im[i] = 0;
+                if (done[i])
+                {
+                    continue;
+                }
+
+                std::complex<double> z(re[i], im[i]);
+                std::complex<double> p, dp;
+                double bound;
+                detail::horner(a, z, p, dp, bound);
+
+                // p(z) is zero or lost in rounding noise: z cannot be improved
+                constexpr double eps = std::numeric_limits<double>::epsilon();
+                if (std::abs(p) <= 4 * static_cast<double>(n) * eps * bound)
+                {
+                    done[i] = true;
+                    continue;
+                }
+
+                // S = sum_{j != i} 1 / (z_i - z_j)
+                double s_re = 0, s_im = 0;
+                for (std::size_t j = 0; j < i; ++j)
+                {
+                    double dr = re[i] - re[j], di = im[i] - im[j];
+                    double d2 = dr * dr + di * di;
+                    s_re += dr / d2;
+                    s_im -= di / d2;
+                }
+                for (std::size_t j = i + 1; j < n; ++j)
+                {
+                    double dr = re[i] - re[j], di = im[i] - im[j];
+                    double d2 = dr * dr + di * di;
+                    s_re += dr / d2;
+                    s_im -= di / d2;
+                }
+
+                // w = (p / p') / (1 - (p / p') S)
+                std::complex<double> ratio = p / dp;
+                std::complex<double> w = ratio / (1.0 - ratio * std::complex<double>(s_re, s_im));
+
+                step_re[i] = w.real();
+                step_im[i] = w.imag();
+
+                if (std::abs(w) <= options.tolerance * std::abs(z))
+                {
+                    done[i] = true;
+                }
+                else
+                {
+                    r.converged = false;
+                }
+            }
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                re[i] -= step_re[i];
+                im[i] -= step_im[i];
+            }
+        }
+
+        r.roots.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            r.roots[i] = {re[i], im[i]};
+        }
+
+        verify_roots<Prec>(a, r);
+
+        return r;
+    }
+
+    //----------------------------------------------------------------------------------------
+    // one result per polynomial, polynomials spread over threads
+    //----------------------------------------------------------------------------------------
+
+    template <size_t Prec = 113>
+    std::vector<polynomial_roots> aberth(std::span<const std::vector<std::complex<double>>> polynomials,
+                                         aberth_options options = {})
+    {
+        std::vector<polynomial_roots> results(polynomials.size());
+
+        detail::parallel_for(polynomials.size(), options.threads, [&](std::size_t k)
+        {
+            results[k] = aberth<Prec>(std::span<const std::complex<double>>(polynomials[k]), options);
+        });
+
+        return results;
+    }
+} // namespace flib
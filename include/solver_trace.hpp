@@ -0,0 +1,246 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+// instrumentação dos solvers.
+//
+// Cada thread grava num ring buffer próprio (um produtor, um consumidor), sem locks e
+// sem I/O no laço do solver. A exportação para CSV ou JSON é feita sob demanda e
+// esvazia os buffers. Quando um buffer enche, as entradas novas são descartadas e
+// contadas em dropped().
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    struct trace_entry
+    {
+        std::uint64_t iteration;
+        double width;
+        long precision;
+        double contraction;   // width / previous width
+        std::uint64_t elapsed_ns;
+    };
+
+    //---------------------------------------
+    // single-producer single-consumer ring
+    //---------------------------------------
+
+    class trace_buffer
+    {
+    private:
+        std::unique_ptr<trace_entry[]> slots;
+        std::size_t mask;
+
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+        alignas(64) std::atomic<std::size_t> lost{0};
+
+    public:
+        // capacity is rounded up to a power of two
+        explicit trace_buffer(std::size_t capacity)
+        {
+            std::size_t n = 1;
+            while (n < capacity)
+            {
+                n <<= 1;
+            }
+            slots = std::make_unique<trace_entry[]>(n);
+            mask = n - 1;
+        }
+
+        bool push(const trace_entry &e)
+        {
+            std::size_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) > mask)
+            {
+                lost.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            slots[h & mask] = e;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <class Fn>
+        std::size_t drain(Fn &&fn)
+        {
+            std::size_t t = tail.load(std::memory_order_relaxed);
+            std::size_t h = head.load(std::memory_order_acquire);
+            for (std::size_t i = t; i != h; ++i)
+            {
+                fn(slots[i & mask]);
+            }
+            tail.store(h, std::memory_order_release);
+            return h - t;
+        }
+
+        std::size_t dropped() const
+        {
+            return lost.load(std::memory_order_relaxed);
+        }
+    };
+
+    //---------------------------------------
+    // per-thread buffers + exporters
+    //---------------------------------------
+
+    class solver_trace
+    {
+    private:
+        using clock = std::chrono::steady_clock;
+
+        std::size_t capacity;
+        std::uint64_t id;
+        clock::time_point start;
+
+        std::mutex registry_mutex;
+        std::vector<std::unique_ptr<trace_buffer>> buffers;
+        std::shared_ptr<void> lifetime = std::make_shared<char>();   // expires with the trace
+
+        static std::uint64_t next_id()
+        {
+            static std::atomic<std::uint64_t> counter{0};
+            return ++counter;
+        }
+
+        // the calling thread's buffer for this trace; the registry lock is taken
+        // once per (thread, trace) pair. Each entry holds a weak reference to its
+        // trace, and entries of destroyed traces are dropped whenever the thread
+        // registers a new buffer, so the map only grows with the live traces.
+        trace_buffer &local()
+        {
+            struct entry
+            {
+                std::weak_ptr<void> trace;
+                trace_buffer *buffer;
+            };
+
+            thread_local std::uint64_t owner = 0;
+            thread_local trace_buffer *buffer = nullptr;
+            thread_local std::unordered_map<std::uint64_t, entry> known;
+
+            if (owner != id)
+            {
+                auto it = known.find(id);
+                if (it == known.end())
+                {
+                    std::erase_if(known, [](const auto &e) { return e.second.trace.expired(); });
+
+                    std::lock_guard<std::mutex> guard(registry_mutex);
+                    buffers.push_back(std::make_unique<trace_buffer>(capacity));
+                    it = known.emplace(id, entry{lifetime, buffers.back().get()}).first;
+                }
+                buffer = it->second.buffer;
+                owner = id;
+            }
+            return *buffer;
+        }
+
+        // restores the stream precision after an export
+        class precision_guard
+        {
+        private:
+            std::ostream &os;
+            std::streamsize saved;
+
+        public:
+            explicit precision_guard(std::ostream &stream)
+                : os(stream), saved(stream.precision(std::numeric_limits<double>::max_digits10))
+            {
+            }
+
+            ~precision_guard()
+            {
+                os.precision(saved);
+            }
+        };
+
+        // drains every buffer; fn(thread index, entry)
+        template <class Fn>
+        void drain(Fn &&fn)
+        {
+            std::lock_guard<std::mutex> guard(registry_mutex);
+            for (std::size_t t = 0; t < buffers.size(); ++t)
+            {
+                buffers[t]->drain([&](const trace_entry &e) { fn(t, e); });
+            }
+        }
+
+    public:
+        explicit solver_trace(std::size_t capacity_per_thread = 1 << 16)
+            : capacity(capacity_per_thread), id(next_id()), start(clock::now())
+        {
+        }
+
+        solver_trace(const solver_trace &) = delete;
+        solver_trace &operator=(const solver_trace &) = delete;
+
+        void record(std::uint64_t iteration, double width, long precision, double contraction)
+        {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+            local().push(trace_entry{iteration, width, precision, contraction, static_cast<std::uint64_t>(ns)});
+        }
+
+        std::size_t dropped()
+        {
+            std::lock_guard<std::mutex> guard(registry_mutex);
+            std::size_t n = 0;
+            for (const auto &b : buffers)
+            {
+                n += b->dropped();
+            }
+            return n;
+        }
+
+        //---------------------------------------
+        // thread,iteration,width,precision,contraction,elapsed_ns
+        //---------------------------------------
+
+        void write_csv(std::ostream &os)
+        {
+            precision_guard guard(os);
+            os << "thread,iteration,width,precision,contraction,elapsed_ns\n";
+            drain([&](std::size_t t, const trace_entry &e)
+            {
+                os << t << ',' << e.iteration << ',' << e.width << ',' << e.precision << ','
+                   << e.contraction << ',' << e.elapsed_ns << '\n';
+            });
+        }
+
+        //---------------------------------------
+        // [ { "thread": ..., ... }, ... ]
+        //---------------------------------------
+
+        void write_json(std::ostream &os)
+        {
+            precision_guard guard(os);
+            // JSON has no inf/nan
+            auto number = [&](double x) -> std::ostream &
+            {
+                return std::isfinite(x) ? os << x : os << "null";
+            };
+
+            const char *separator = "\n";
+            os << '[';
+            drain([&](std::size_t t, const trace_entry &e)
+            {
+                os << separator << "  {\"thread\": " << t << ", \"iteration\": " << e.iteration << ", \"width\": ";
+                number(e.width) << ", \"precision\": " << e.precision << ", \"contraction\": ";
+                number(e.contraction) << ", \"elapsed_ns\": " << e.elapsed_ns << '}';
+                separator = ",\n";
+            });
+            os << "\n]\n";
+        }
+    };
+} // namespace flib
@@ -0,0 +1,550 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+#include "autodiff.hpp"
+
+//----------------------------------------------------------------------------------------
+// diferenciação simbólica em tempo de compilação.
+//
+// Cada expressão é um tipo vazio: var, constant<V>, add<L, R>, sin_<E>, ... A derivada
+// de uma expressão é outro tipo, construído pelos próprios operadores, que simplificam
+// na construção (0 + e = e, 1 * e = e, 0 * e = 0, constantes são dobradas).
+//
+// Para avaliar f, f' e f'' cada nó tem jet(), que recebe {u, u', u''} dos filhos e
+// devolve os seus, de baixo para cima, numa única passada: cada seno, cosseno ou
+// exponencial é calculado uma vez. Um operando constante entra só com seu valor, sem
+// derivadas em tempo de execução, de modo que as derivadas de subexpressões constantes
+// somem na compilação. Depois de inlinado, é código linear sem nenhum controle de AD.
+//
+//   using namespace flib::symbolic;
+//   constexpr auto f = sin(x) / exp(x);
+//   fdh r = evaluate(f, 2.0);   // {f(2), f'(2), f''(2)}
+//----------------------------------------------------------------------------------------
+
+namespace flib::symbolic
+{
+    template <class E>
+    struct expression
+    {
+        // f(x)
+        constexpr double operator()(double v) const
+        {
+            return E::eval(v);
+        }
+
+        // chain rule, so an expression is also a newton_function
+        constexpr fdh operator()(fdh v) const;
+    };
+
+    template <class E>
+    concept expression_type = std::is_base_of_v<expression<E>, E>;
+
+    //---------------------------------------
+    // leaves
+    //---------------------------------------
+
+    struct var : expression<var>
+    {
+        static constexpr double eval(double v) { return v; }
+        static constexpr fdh jet(fdh v) { return v; }
+    };
+
+    template <double V>
+    struct constant : expression<constant<V>>
+    {
+        static constexpr double value = V;
+        static constexpr double eval(double) { return V; }
+        static constexpr fdh jet(fdh) { return fdh{V, 0, 0}; }
+    };
+
+    inline constexpr var x{};
+
+    template <double V>
+    inline constexpr constant<V> c{};
+
+    using zero = constant<0.0>;
+    using one = constant<1.0>;
+
+    template <class E>
+    inline constexpr bool is_constant = false;
+
+    template <double V>
+    inline constexpr bool is_constant<constant<V>> = true;
+
+    template <class E>
+    inline constexpr bool is_zero = std::is_same_v<E, zero>;
+
+    template <class E>
+    inline constexpr bool is_one = std::is_same_v<E, one>;
+
+    //---------------------------------------
+    // nodes
+    //---------------------------------------
+
+    template <class L, class R>
+    struct add : expression<add<L, R>>
+    {
+        static constexpr double eval(double v) { return L::eval(v) + R::eval(v); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            if constexpr (is_constant<L>)
+            {
+                fdh b = R::jet(v);
+                return fdh{L::value + b.f, b.d, b.h};
+            }
+            else if constexpr (is_constant<R>)
+            {
+                fdh a = L::jet(v);
+                return fdh{a.f + R::value, a.d, a.h};
+            }
+            else
+            {
+                fdh a = L::jet(v);
+                fdh b = R::jet(v);
+                return fdh{a.f + b.f, a.d + b.d, a.h + b.h};
+            }
+        }
+    };
+
+    template <class L, class R>
+    struct sub : expression<sub<L, R>>
+    {
+        static constexpr double eval(double v) { return L::eval(v) - R::eval(v); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            if constexpr (is_constant<L>)
+            {
+                fdh b = R::jet(v);
+                return fdh{L::value - b.f, -b.d, -b.h};
+            }
+            else if constexpr (is_constant<R>)
+            {
+                fdh a = L::jet(v);
+                return fdh{a.f - R::value, a.d, a.h};
+            }
+            else
+            {
+                fdh a = L::jet(v);
+                fdh b = R::jet(v);
+                return fdh{a.f - b.f, a.d - b.d, a.h - b.h};
+            }
+        }
+    };
+
+    template <class L, class R>
+    struct mul : expression<mul<L, R>>
+    {
+        static constexpr double eval(double v) { return L::eval(v) * R::eval(v); }
+
+        // (ab)'' = a''b + 2a'b' + ab''; a constant factor only scales
+        static constexpr fdh jet(fdh v)
+        {
+            if constexpr (is_constant<L>)
+            {
+                fdh b = R::jet(v);
+                return fdh{L::value * b.f, L::value * b.d, L::value * b.h};
+            }
+            else if constexpr (is_constant<R>)
+            {
+                fdh a = L::jet(v);
+                return fdh{a.f * R::value, a.d * R::value, a.h * R::value};
+            }
+            else
+            {
+                fdh a = L::jet(v);
+                fdh b = R::jet(v);
+                return fdh{a.f * b.f, a.d * b.f + a.f * b.d, a.h * b.f + 2 * a.d * b.d + a.f * b.h};
+            }
+        }
+    };
+
+    template <class L, class R>
+    struct div : expression<div<L, R>>
+    {
+        static constexpr double eval(double v) { return L::eval(v) / R::eval(v); }
+
+        // q = a/b:  q' = (a' - q b') / b,  q'' = (a'' - 2 q' b' - q b'') / b
+        static constexpr fdh jet(fdh v)
+        {
+            if constexpr (is_constant<R>)
+            {
+                fdh a = L::jet(v);
+                return fdh{a.f / R::value, a.d / R::value, a.h / R::value};
+            }
+            else if constexpr (is_constant<L>)
+            {
+                fdh b = R::jet(v);
+                double q = L::value / b.f;
+                double dq = -q * b.d / b.f;
+                return fdh{q, dq, (-2 * dq * b.d - q * b.h) / b.f};
+            }
+            else
+            {
+                fdh a = L::jet(v);
+                fdh b = R::jet(v);
+                double q = a.f / b.f;
+                double dq = (a.d - q * b.d) / b.f;
+                return fdh{q, dq, (a.h - 2 * dq * b.d - q * b.h) / b.f};
+            }
+        }
+    };
+
+    template <class E>
+    struct neg : expression<neg<E>>
+    {
+        using operand = E;
+        static constexpr double eval(double v) { return -E::eval(v); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            fdh a = E::jet(v);
+            return fdh{-a.f, -a.d, -a.h};
+        }
+    };
+
+    template <class E>
+    inline constexpr bool is_neg = false;
+
+    template <class E>
+    inline constexpr bool is_neg<neg<E>> = true;
+
+    template <class E>
+    struct sin_ : expression<sin_<E>>
+    {
+        static constexpr double eval(double v) { return std::sin(E::eval(v)); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            fdh u = E::jet(v);
+            double s = std::sin(u.f);
+            double c = std::cos(u.f);
+            return fdh{s, c * u.d, c * u.h - s * u.d * u.d};
+        }
+    };
+
+    template <class E>
+    struct cos_ : expression<cos_<E>>
+    {
+        static constexpr double eval(double v) { return std::cos(E::eval(v)); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            fdh u = E::jet(v);
+            double s = std::sin(u.f);
+            double c = std::cos(u.f);
+            return fdh{c, -s * u.d, -c * u.d * u.d - s * u.h};
+        }
+    };
+
+    template <class E>
+    struct exp_ : expression<exp_<E>>
+    {
+        static constexpr double eval(double v) { return std::exp(E::eval(v)); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            fdh u = E::jet(v);
+            double e = std::exp(u.f);
+            return fdh{e, e * u.d, e * (u.d * u.d + u.h)};
+        }
+    };
+
+    template <class E>
+    struct log_ : expression<log_<E>>
+    {
+        static constexpr double eval(double v) { return std::log(E::eval(v)); }
+
+        static constexpr fdh jet(fdh v)
+        {
+            fdh u = E::jet(v);
+            double r = u.d / u.f;
+            return fdh{std::log(u.f), r, u.h / u.f - r * r};
+        }
+    };
+
+    // integer power by repeated squaring; K is known at compile time
+    template <class E, int K>
+    struct pow_ : expression<pow_<E, K>>
+    {
+        static constexpr double power(double b, int k)
+        {
+            double r = 1;
+            for (; k > 0; k >>= 1, b *= b)
+            {
+                if (k & 1)
+                {
+                    r *= b;
+                }
+            }
+            return r;
+        }
+
+        static constexpr double eval(double v)
+        {
+            if constexpr (K >= 0)
+            {
+                return power(E::eval(v), K);
+            }
+            else
+            {
+                return 1 / power(E::eval(v), -K);
+            }
+        }
+
+        // u^k from u^(k-2): one power per node
+        static constexpr fdh jet(fdh v)
+        {
+            fdh u = E::jet(v);
+            double p2 = K >= 2 ? power(u.f, K - 2) : 1 / power(u.f, 2 - K);
+            double p1 = p2 * u.f;
+            double k = K;
+            return fdh{p1 * u.f, k * p1 * u.d, k * (k - 1) * p2 * u.d * u.d + k * p1 * u.h};
+        }
+    };
+
+    //---------------------------------------
+    // simplifying constructors
+    //---------------------------------------
+
+    template <expression_type L, expression_type R>
+    constexpr auto operator+(L, R)
+    {
+        if constexpr (is_constant<L> && is_constant<R>)
+        {
+            return constant<L::value + R::value>{};
+        }
+        else if constexpr (is_zero<L>)
+        {
+            return R{};
+        }
+        else if constexpr (is_zero<R>)
+        {
+            return L{};
+        }
+        else
+        {
+            return add<L, R>{};
+        }
+    }
+
+    template <expression_type E>
+    constexpr auto operator-(E)
+    {
+        if constexpr (is_constant<E>)
+        {
+            return constant<-E::value>{};
+        }
+        else if constexpr (is_neg<E>)
+        {
+            return typename E::operand{};
+        }
+        else
+        {
+            return neg<E>{};
+        }
+    }
+
+    template <expression_type L, expression_type R>
+    constexpr auto operator-(L, R)
+    {
+        if constexpr (is_constant<L> && is_constant<R>)
+        {
+            return constant<L::value - R::value>{};
+        }
+        else if constexpr (is_zero<R>)
+        {
+            return L{};
+        }
+        else if constexpr (is_zero<L>)
+        {
+            return -R{};
+        }
+        else if constexpr (std::is_same_v<L, R>)
+        {
+            return zero{};
+        }
+        else
+        {
+            return sub<L, R>{};
+        }
+    }
+
+    template <expression_type L, expression_type R>
+    constexpr auto operator*(L, R)
+    {
+        if constexpr (is_constant<L> && is_constant<R>)
+        {
+            return constant<L::value * R::value>{};
+        }
+        else if constexpr (is_zero<L> || is_zero<R>)
+        {
+            return zero{};
+        }
+        else if constexpr (is_one<L>)
+        {
+            return R{};
+        }
+        else if constexpr (is_one<R>)
+        {
+            return L{};
+        }
+        else if constexpr (std::is_same_v<L, constant<-1.0>>)
+        {
+            return -R{};
+        }
+        else if constexpr (std::is_same_v<R, constant<-1.0>>)
+        {
+            return -L{};
+        }
+        else
+        {
+            return mul<L, R>{};
+        }
+    }
+
+    template <expression_type L, expression_type R>
+    constexpr auto operator/(L, R)
+    {
+        static_assert(!is_zero<R>, "Division by zero is undefined");
+
+        if constexpr (is_constant<L> && is_constant<R>)
+        {
+            return constant<L::value / R::value>{};
+        }
+        else if constexpr (is_zero<L>)
+        {
+            return zero{};
+        }
+        else if constexpr (is_one<R>)
+        {
+            return L{};
+        }
+        else if constexpr (std::is_same_v<L, R>)
+        {
+            return one{};
+        }
+        else
+        {
+            return div<L, R>{};
+        }
+    }
+
+    template <expression_type E>
+    constexpr auto sin(E) { return sin_<E>{}; }
+
+    template <expression_type E>
+    constexpr auto cos(E) { return cos_<E>{}; }
+
+    template <expression_type E>
+    constexpr auto exp(E)
+    {
+        if constexpr (is_zero<E>)
+        {
+            return one{};
+        }
+        else
+        {
+            return exp_<E>{};
+        }
+    }
+
+    template <expression_type E>
+    constexpr auto log(E)
+    {
+        if constexpr (is_one<E>)
+        {
+            return zero{};
+        }
+        else
+        {
+            return log_<E>{};
+        }
+    }
+
+    template <int K, expression_type E>
+    constexpr auto pow(E)
+    {
+        if constexpr (K == 0)
+        {
+            return one{};
+        }
+        else if constexpr (K == 1)
+        {
+            return E{};
+        }
+        else if constexpr (is_constant<E>)
+        {
+            return constant<pow_<E, K>::eval(0.0)>{};
+        }
+        else
+        {
+            return pow_<E, K>{};
+        }
+    }
+
+    //---------------------------------------
+    // d/dx
+    //---------------------------------------
+
+    constexpr auto derivative(var) { return one{}; }
+
+    template <double V>
+    constexpr auto derivative(constant<V>) { return zero{}; }
+
+    template <class L, class R>
+    constexpr auto derivative(add<L, R>) { return derivative(L{}) + derivative(R{}); }
+
+    template <class L, class R>
+    constexpr auto derivative(sub<L, R>) { return derivative(L{}) - derivative(R{}); }
+
+    template <class E>
+    constexpr auto derivative(neg<E>) { return -derivative(E{}); }
+
+    // (uv)' = u'v + uv'
+    template <class L, class R>
+    constexpr auto derivative(mul<L, R>) { return derivative(L{}) * R{} + L{} * derivative(R{}); }
+
+    // (u/v)' = (u'v - uv') / v^2
+    template <class L, class R>
+    constexpr auto derivative(div<L, R>)
+    {
+        return (derivative(L{}) * R{} - L{} * derivative(R{})) / pow<2>(R{});
+    }
+
+    template <class E>
+    constexpr auto derivative(sin_<E>) { return cos(E{}) * derivative(E{}); }
+
+    template <class E>
+    constexpr auto derivative(cos_<E>) { return -(sin(E{}) * derivative(E{})); }
+
+    template <class E>
+    constexpr auto derivative(exp_<E>) { return exp_<E>{} * derivative(E{}); }
+
+    template <class E>
+    constexpr auto derivative(log_<E>) { return derivative(E{}) / E{}; }
+
+    template <class E, int K>
+    constexpr auto derivative(pow_<E, K>)
+    {
+        return constant<static_cast<double>(K)>{} * pow<K - 1>(E{}) * derivative(E{});
+    }
+
+    //---------------------------------------
+    // {f(v), f'(v), f''(v)}
+    //---------------------------------------
+
+    template <expression_type E>
+    constexpr fdh evaluate(E, double v)
+    {
+        return E::jet(fdh{v, 1, 0});
+    }
+
+    // the jets carry the chain rule: v = {u, u', u''} gives {f(u), (f o u)', (f o u)''}
+    template <class E>
+    constexpr fdh expression<E>::operator()(fdh v) const
+    {
+        return E::jet(v);
+    }
+} // namespace flib::symbolic
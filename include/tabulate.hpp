@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "autodiff.hpp"
+#include "interval.hpp"
+#include "parallel.hpp"
+
+//----------------------------------------------------------------------------------------
+// tabulação de funções em grades 1D/2D.
+//
+// Nos pontos da grade, f é avaliada com fdh (valor, f' e f''). Em cada célula entre
+// pontos vizinhos, f é avaliada com aritmética intervalar, o que dá limites rigorosos
+// da imagem da célula. A grade é dividida em blocos (tiles) que cabem no cache e que
+// as threads pegam de um contador atômico. Os resultados vão direto para os spans do
+// chamador, que podem apontar para memória mapeada.
+//
+// f é um único chamável com sobrecargas para fdh e para interval<mpfr_t, Prec>, por
+// exemplo my_f.
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    // n points from a to b, both included
+    struct grid_1d
+    {
+        double a;
+        double b;
+        std::size_t n;
+
+        double operator[](std::size_t i) const
+        {
+            return i + 1 == n ? b : a + static_cast<double>(i) * ((b - a) / static_cast<double>(n - 1));
+        }
+    };
+
+    struct tabulate_options
+    {
+        std::size_t tile = 64;   // tile edge in points (2D) or tile * tile points (1D)
+        unsigned threads = 0;    // 0 = std::thread::hardware_concurrency()
+    };
+
+    namespace detail
+    {
+        // a <= b, both finite, and at least two points
+        inline bool valid(const grid_1d &g)
+        {
+            return g.n >= 2 && std::isfinite(g.a) && std::isfinite(g.b) && g.a <= g.b;
+        }
+
+        // enclosure of f over a cell, [-inf, inf] when f cannot be enclosed there
+        template <class Eval>
+        void enclose(Eval eval, double &lower, double &upper)
+        {
+            try
+            {
+                auto r = eval();
+                lower = r.inf();
+                upper = r.sup();
+            }
+            catch (const std::domain_error &)
+            {
+                lower = -std::numeric_limits<double>::infinity();
+                upper = std::numeric_limits<double>::infinity();
+            }
+        }
+    } // namespace detail
+
+    //----------------------------------------------------------------------------------------
+    // 1D
+    //
+    //   values[i]              = f( fdh{x_i, 1, 0} )
+    //   [lower[i], upper[i]]  ⊇ f( [x_i, x_{i+1}] ),   i < n - 1
+    //
+    // lower and upper may be empty to skip the enclosures.
+    //----------------------------------------------------------------------------------------
+
+    template <size_t Prec, class F>
+    void tabulate(F f, grid_1d g, std::span<fdh> values, std::span<double> lower, std::span<double> upper,
+                  tabulate_options options = {})
+    {
+        using interval_t = interval<mpfr_t, Prec>;
+
+        if (!detail::valid(g))
+        {
+            throw std::invalid_argument("Invalid grid: needs finite a <= b and n >= 2");
+        }
+        if (values.size() != g.n || lower.size() != upper.size() || (!lower.empty() && lower.size() != g.n - 1))
+        {
+            throw std::invalid_argument("Output spans do not match the grid");
+        }
+
+        std::size_t tile = std::max<std::size_t>(1, options.tile * options.tile);
+        std::size_t tiles = (g.n + tile - 1) / tile;
+
+        detail::parallel_for(tiles, options.threads, [&](std::size_t t)
+        {
+            std::size_t begin = t * tile;
+            std::size_t end = std::min(begin + tile, g.n);
+
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                values[i] = f(fdh{g[i], 1, 0});
+            }
+
+            if (!lower.empty())
+            {
+                for (std::size_t i = begin; i < std::min(end, g.n - 1); ++i)
+                {
+                    detail::enclose([&] { return f(interval_t(g[i], g[i + 1])); }, lower[i], upper[i]);
+                }
+            }
+        });
+    }
+
+    //----------------------------------------------------------------------------------------
+    // 2D, row-major (x fastest)
+    //
+    //   values[j nx + i]                    = f( fdh{x_i, 1, 0}, fdh{y_j, 0, 0} )
+    //   [lower, upper][j (nx-1) + i]       ⊇ f( [x_i, x_{i+1}], [y_j, y_{j+1}] )
+    //
+    // the fdh derivatives are taken with respect to x.
+    //----------------------------------------------------------------------------------------
+
+    template <size_t Prec, class F>
+    void tabulate(F f, grid_1d gx, grid_1d gy, std::span<fdh> values, std::span<double> lower, std::span<double> upper,
+                  tabulate_options options = {})
+    {
+        using interval_t = interval<mpfr_t, Prec>;
+
+        std::size_t nx = gx.n;
+        std::size_t ny = gy.n;
+
+        if (!detail::valid(gx) || !detail::valid(gy))
+        {
+            throw std::invalid_argument("Invalid grid: needs finite a <= b and n >= 2");
+        }
+        if (values.size() != nx * ny || lower.size() != upper.size() ||
+            (!lower.empty() && lower.size() != (nx - 1) * (ny - 1)))
+        {
+            throw std::invalid_argument("Output spans do not match the grid");
+        }
+
+        std::size_t tile = std::max<std::size_t>(1, options.tile);
+        std::size_t tiles_x = (nx + tile - 1) / tile;
+        std::size_t tiles_y = (ny + tile - 1) / tile;
+
+        detail::parallel_for(tiles_x * tiles_y, options.threads, [&](std::size_t t)
+        {
+            std::size_t i0 = (t % tiles_x) * tile;
+            std::size_t j0 = (t / tiles_x) * tile;
+            std::size_t i1 = std::min(i0 + tile, nx);
+            std::size_t j1 = std::min(j0 + tile, ny);
+
+            for (std::size_t j = j0; j < j1; ++j)
+            {
+                fdh y{gy[j], 0, 0};
+                for (std::size_t i = i0; i < i1; ++i)
+                {
+                    values[j * nx + i] = f(fdh{gx[i], 1, 0}, y);
+                }
+            }
+
+            if (!lower.empty())
+            {
+                for (std::size_t j = j0; j < std::min(j1, ny - 1); ++j)
+                {
+                    interval_t y(gy[j], gy[j + 1]);
+                    for (std::size_t i = i0; i < std::min(i1, nx - 1); ++i)
+                    {
+                        std::size_t k = j * (nx - 1) + i;
+                        detail::enclose([&] { return f(interval_t(gx[i], gx[i + 1]), y); }, lower[k], upper[k]);
+                    }
+                }
+            }
+        });
+    }
+} // namespace flib
@@ -0,0 +1,416 @@
+#include "batch.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "expression_tape.hpp"
+#include "interval.hpp"
+#include "newton_function.hpp"
+#include "parallel.hpp"
+
+namespace flib
+{
+    namespace
+    {
+        //---------------------------------------
+        // numbers from a memory-mapped file or
+        // from stdin
+        //---------------------------------------
+
+        class number_source
+        {
+        private:
+            const char *data = nullptr;
+            std::size_t size = 0;
+            std::size_t pos = 0;
+            int fd = -1;
+            std::string token;
+
+            // stdin, one whitespace-separated token at a time, parsed like the mapped file
+            bool next_token(double &v)
+            {
+                if (!(std::cin >> token))
+                {
+                    if (std::cin.bad())
+                    {
+                        throw std::runtime_error("Error reading stdin");
+                    }
+                    return false;
+                }
+
+                const char *first = token.data();
+                const char *last = first + token.size();
+                auto [end, ec] = std::from_chars(first, last, v);
+                if (ec != std::errc() || end != last)
+                {
+                    throw std::invalid_argument("Invalid number '" + token + "' on stdin");
+                }
+                return true;
+            }
+
+        public:
+            explicit number_source(const std::string &path)
+            {
+                if (path.empty() || path == "-")
+                {
+                    return;
+                }
+
+                fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    throw std::invalid_argument("Cannot open " + path + ": " + std::strerror(errno));
+                }
+
+                struct stat st;
+                ::fstat(fd, &st);
+                size = static_cast<std::size_t>(st.st_size);
+                if (size > 0)
+                {
+                    void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p == MAP_FAILED)
+                    {
+                        ::close(fd);
+                        throw std::invalid_argument("Cannot map " + path + ": " + std::strerror(errno));
+                    }
+                    ::madvise(p, size, MADV_SEQUENTIAL);
+                    data = static_cast<const char *>(p);
+                }
+            }
+
+            number_source(const number_source &) = delete;
+            number_source &operator=(const number_source &) = delete;
+
+            ~number_source()
+            {
+                if (data != nullptr)
+                {
+                    ::munmap(const_cast<char *>(data), size);
+                }
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+            }
+
+            bool next(double &v)
+            {
+                if (fd < 0)
+                {
+                    return next_token(v);
+                }
+
+                while (pos < size && std::isspace(static_cast<unsigned char>(data[pos])))
+                {
+                    ++pos;
+                }
+                if (pos == size)
+                {
+                    return false;
+                }
+
+                auto [end, ec] = std::from_chars(data + pos, data + size, v);
+                if (ec != std::errc())
+                {
+                    throw std::invalid_argument("Invalid number at byte " + std::to_string(pos));
+                }
+                pos = static_cast<std::size_t>(end - data);
+                return true;
+            }
+        };
+
+        enum class box_status : std::int64_t
+        {
+            root = 0,   // [lo, hi] holds every root of the input box
+            none = 1,   // proved to hold no root
+            open = 2    // f' contains zero or f cannot be enclosed: box returned as is
+        };
+
+        struct box_result
+        {
+            box_status status;
+            double lo;
+            double hi;
+        };
+
+        //---------------------------------------
+        // interval Newton on [lo, hi]
+        //---------------------------------------
+
+        template <size_t Prec>
+        box_result solve_box(const tape &t, double lo, double hi, int iterations)
+        {
+            using interval_t = interval<mpfr_t, Prec>;
+
+            if (!(lo <= hi))
+            {
+                return {box_status::open, lo, hi};
+            }
+
+            interval_t x(lo, hi);
+            box_status status = box_status::open;
+
+            try
+            {
+                for (int i = 0; i < iterations; ++i)
+                {
+                    auto [fx, dx] = t.evaluate_with_derivative(x);
+                    if (!fx.has_zero())
+                    {
+                        return {box_status::none, lo, hi};
+                    }
+                    if (dx.has_zero())
+                    {
+                        break;
+                    }
+
+                    interval_t m = x.mid();
+                    interval_t n = m - t.evaluate(m) / dx;
+
+                    double width = x.sup() - x.inf();
+                    try
+                    {
+                        x = interval_t::intersection(x, n);
+                    }
+                    catch (const std::domain_error &)
+                    {
+                        return {box_status::none, lo, hi};
+                    }
+                    status = box_status::root;
+
+                    if (x.sup() - x.inf() >= width)
+                    {
+                        break;
+                    }
+                }
+            }
+            catch (const std::domain_error &)
+            {
+                return {status, x.inf(), x.sup()};
+            }
+
+            return {status, x.inf(), x.sup()};
+        }
+
+        using box_solver = box_result (*)(const tape &, double, double, int);
+
+        box_solver box_solver_for(std::size_t precision)
+        {
+            switch (precision)
+            {
+            case 53: return solve_box<53>;
+            case 113: return solve_box<113>;
+            case 256: return solve_box<256>;
+            case 512: return solve_box<512>;
+            case 1024: return solve_box<1024>;
+            default: throw std::invalid_argument("Precision must be 53, 113, 256, 512 or 1024");
+            }
+        }
+
+        //---------------------------------------
+        // output
+        //---------------------------------------
+
+        class writer
+        {
+        private:
+            std::vector<char> buffer;
+            bool binary;
+
+            void flush()
+            {
+                std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+                buffer.clear();
+            }
+
+        public:
+            explicit writer(bool binary_output) : binary(binary_output)
+            {
+                buffer.reserve(1 << 20);
+            }
+
+            ~writer()
+            {
+                flush();
+                std::fflush(stdout);
+            }
+
+            // binary only
+            void code(std::int64_t c)
+            {
+                if (binary)
+                {
+                    const char *p = reinterpret_cast<const char *>(&c);
+                    buffer.insert(buffer.end(), p, p + sizeof c);
+                }
+            }
+
+            void number(double v)
+            {
+                if (binary)
+                {
+                    const char *p = reinterpret_cast<const char *>(&v);
+                    buffer.insert(buffer.end(), p, p + sizeof v);
+                }
+                else
+                {
+                    char s[32];
+                    auto [end, ec] = std::to_chars(s, s + sizeof s, v);
+                    buffer.insert(buffer.end(), s, end);
+                }
+                if (buffer.size() >= (1 << 20))
+                {
+                    flush();
+                }
+            }
+
+            void text(std::string_view s)
+            {
+                if (!binary)
+                {
+                    buffer.insert(buffer.end(), s.begin(), s.end());
+                }
+            }
+        };
+    } // namespace
+
+    batch_options parse_batch_options(int argc, char **argv)
+    {
+        batch_options o;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view a = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::invalid_argument("Missing value for " + std::string(a));
+                }
+                return argv[++i];
+            };
+
+            if (a == "--batch")
+            {
+                o.expression = value();
+            }
+            else if (a == "--input")
+            {
+                o.input = value();
+            }
+            else if (a == "--boxes")
+            {
+                o.boxes = true;
+            }
+            else if (a == "--binary")
+            {
+                o.binary = true;
+            }
+            else if (a == "--precision")
+            {
+                o.precision = std::stoul(value());
+            }
+            else if (a == "--threads")
+            {
+                o.threads = static_cast<unsigned>(std::stoul(value()));
+            }
+            else if (a == "--iterations")
+            {
+                o.iterations = std::stoi(value());
+            }
+            else if (a == "--chunk")
+            {
+                o.chunk = std::max<std::size_t>(1, std::stoul(value()));
+            }
+            else
+            {
+                throw std::invalid_argument("Unknown option " + std::string(a));
+            }
+        }
+
+        if (o.expression.empty())
+        {
+            throw std::invalid_argument("--batch needs an expression");
+        }
+        return o;
+    }
+
+    int run_batch(const batch_options &o)
+    {
+        const tape t = tape::parse(o.expression);
+        number_source source(o.input);
+        writer out(o.binary);
+
+        box_solver solve = o.boxes ? box_solver_for(o.precision) : nullptr;
+        std::size_t width = o.boxes ? 2 : 1;
+
+        std::vector<double> in;
+        std::vector<box_result> boxes;
+        in.reserve(o.chunk * width);
+
+        auto f = [&t](fdh x) { return t.evaluate(x); };
+
+        while (true)
+        {
+            in.clear();
+            double v;
+            while (in.size() < o.chunk * width && source.next(v))
+            {
+                in.push_back(v);
+            }
+            if (in.size() % width != 0)
+            {
+                throw std::invalid_argument("--boxes needs pairs \"lo hi\": the input ends with a single value");
+            }
+            if (in.empty())
+            {
+                break;
+            }
+
+            std::size_t n = in.size() / width;
+
+            if (!o.boxes)
+            {
+                detail::parallel_for(n, o.threads, [&](std::size_t i) { in[i] = newton(f, in[i], o.iterations); });
+
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    out.number(in[i]);
+                    out.text("\n");
+                }
+                continue;
+            }
+
+            boxes.resize(n);
+            detail::parallel_for(n, o.threads, [&](std::size_t i) { boxes[i] = solve(t, in[2 * i], in[2 * i + 1], o.iterations); });
+
+            // text: "root lo hi", "none lo hi" or "open lo hi";
+            // binary: {int64 status, double lo, double hi}
+            for (const box_result &b : boxes)
+            {
+                out.text(b.status == box_status::root ? "root " : b.status == box_status::none ? "none " : "open ");
+                out.code(static_cast<std::int64_t>(b.status));
+                out.number(b.lo);
+                out.text(" ");
+                out.number(b.hi);
+                out.text("\n");
+            }
+        }
+
+        return 0;
+    }
+} // namespace flib
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+//----------------------------------------------------------------------------------------
+// modo batch do executável AutoDiff
+//
+//   AutoDiff --batch "expr" [--input file] [--boxes] [--binary] [--precision P]
+//            [--threads N] [--iterations K] [--chunk C]
+//
+// Lê pontos iniciais (um número por entrada) ou caixas (dois números) da entrada
+// padrão ou de um arquivo mapeado em memória, resolve em blocos de C entradas em
+// paralelo e escreve cada bloco antes de ler o próximo, com memória limitada.
+//
+// Saída com --binary, na ordem de bytes nativa:
+//
+//   pontos: um double (a raiz) por entrada
+//   caixas: um registro de 24 bytes por entrada, { int64 status, double lo, double hi },
+//           status 0 = root (todas as raízes da caixa estão em [lo, hi]),
+//                  1 = none (a caixa não tem raiz; [lo, hi] é a caixa de entrada),
+//                  2 = open (não resolvida; [lo, hi] é a última caixa)
+//----------------------------------------------------------------------------------------
+
+namespace flib
+{
+    struct batch_options
+    {
+        std::string expression;
+        std::string input;          // empty = stdin
+        bool boxes = false;         // interval Newton on [a, b] instead of Newton from x0
+        bool binary = false;        // raw doubles instead of text
+        std::size_t precision = 113;
+        unsigned threads = 0;       // 0 = std::thread::hardware_concurrency()
+        int iterations = 20;
+        std::size_t chunk = 1 << 16;
+    };
+
+    // throws std::invalid_argument on malformed arguments
+    batch_options parse_batch_options(int argc, char **argv);
+
+    // returns the process exit code
+    int run_batch(const batch_options &options);
+} // namespace flib
@@ -0,0 +1,362 @@
+#include "interval.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace flib
+{
+    namespace detail
+    {
+        //----------------------------------------------------------
+        // [a , b] * [c , d] = [min A, max A], A = {ac, ad, bc, bd}
+        //
+        // every product is rounded down for the minimum and up for
+        // the maximum
+        //----------------------------------------------------------
+
+        void mul(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu)
+        {
+            mpfr_t p;
+            mpfr_t lo, hi;
+            mpfr_inits2(mpfr_get_prec(rl), p, lo, hi, NULL);
+
+            mpfr_srcptr x[4] = {al, al, au, au};
+            mpfr_srcptr y[4] = {bl, bu, bl, bu};
+
+            mpfr_mul(lo, x[0], y[0], MPFR_RNDD);
+            mpfr_mul(hi, x[0], y[0], MPFR_RNDU);
+
+            for (int i = 1; i < 4; ++i)
+            {
+                mpfr_mul(p, x[i], y[i], MPFR_RNDD);
+                mpfr_min(lo, lo, p, MPFR_RNDD);
+
+                mpfr_mul(p, x[i], y[i], MPFR_RNDU);
+                mpfr_max(hi, hi, p, MPFR_RNDU);
+            }
+
+            mpfr_set(rl, lo, MPFR_RNDD);
+            mpfr_set(ru, hi, MPFR_RNDU);
+
+            mpfr_clears(p, lo, hi, NULL);
+        }
+
+        //----------------------------------------------------------
+        // [a , b] / [c, d] =  [a , b] * ( 1 / [c, d] )
+        //----------------------------------------------------------
+
+        void div(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu)
+        {
+            mpfr_t recip_l, recip_u;
+            mpfr_inits2(mpfr_get_prec(rl), recip_l, recip_u, NULL);
+
+            mpfr_ui_div(recip_l, 1, bu, MPFR_RNDD);
+            mpfr_ui_div(recip_u, 1, bl, MPFR_RNDU);
+
+            mul(rl, ru, al, au, recip_l, recip_u);
+
+            mpfr_clears(recip_l, recip_u, NULL);
+        }
+
+        //------------------------------------------------
+        // "[ l , u ]"
+        //------------------------------------------------
+
+        void print(std::ostream &os, mpfr_srcptr l, mpfr_srcptr u, int digits)
+        {
+            char *lb;
+            char *ub;
+            mpfr_asprintf(&lb, "%.*RDe", digits, l);
+            mpfr_asprintf(&ub, "%.*RUe", digits, u);
+            os << "[ " << lb << " , " << ub << " ]";
+            mpfr_free_str(lb);
+            mpfr_free_str(ub);
+        }
+
+        //------------------------------------------------
+        // exact products
+        //------------------------------------------------
+
+        namespace
+        {
+            // [lo, hi] = [al, au] * [bl, bu] without rounding; lo, hi and p must have
+            // at least prec(a) + prec(b) bits
+            void exact_product(mpfr_ptr lo, mpfr_ptr hi, mpfr_ptr p, mpfr_srcptr al, mpfr_srcptr au,
+                               mpfr_srcptr bl, mpfr_srcptr bu)
+            {
+                mpfr_mul(lo, al, bl, MPFR_RNDN);
+                mpfr_set(hi, lo, MPFR_RNDN);
+
+                // point intervals: one product
+                if (mpfr_cmp(al, au) == 0 && mpfr_cmp(bl, bu) == 0)
+                {
+                    return;
+                }
+
+                mpfr_srcptr x[3] = {al, au, au};
+                mpfr_srcptr y[3] = {bu, bl, bu};
+                for (int i = 0; i < 3; ++i)
+                {
+                    mpfr_mul(p, x[i], y[i], MPFR_RNDN);
+                    if (mpfr_cmp(p, lo) < 0)
+                    {
+                        mpfr_set(lo, p, MPFR_RNDN);
+                    }
+                    if (mpfr_cmp(p, hi) > 0)
+                    {
+                        mpfr_set(hi, p, MPFR_RNDN);
+                    }
+                }
+            }
+
+            mpfr_prec_t product_prec(mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu)
+            {
+                return std::max(mpfr_get_prec(al), mpfr_get_prec(au)) + std::max(mpfr_get_prec(bl), mpfr_get_prec(bu));
+            }
+        } // namespace
+
+        //------------------------------------------------
+        // [a, b] * [c, d] + [e, f]
+        //------------------------------------------------
+
+        void fma(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu,
+                 mpfr_srcptr cl, mpfr_srcptr cu)
+        {
+            mpfr_t lo, hi, p;
+            mpfr_inits2(product_prec(al, au, bl, bu), lo, hi, p, NULL);
+
+            exact_product(lo, hi, p, al, au, bl, bu);
+
+            mpfr_add(rl, lo, cl, MPFR_RNDD);
+            mpfr_add(ru, hi, cu, MPFR_RNDU);
+
+            mpfr_clears(lo, hi, p, NULL);
+        }
+
+        //------------------------------------------------
+        // sum_i [a_i, b_i] * [c_i, d_i]
+        //
+        // the bounds of every term are exact; mpfr_sum
+        // rounds the whole sum once
+        //------------------------------------------------
+
+        void dot(mpfr_ptr rl, mpfr_ptr ru, const mpfr_ptr *al, const mpfr_ptr *au, const mpfr_ptr *bl,
+                 const mpfr_ptr *bu, std::size_t n)
+        {
+            std::vector<__mpfr_struct> terms(2 * n);
+            std::vector<mpfr_ptr> lo(n), hi(n);
+
+            mpfr_t p;
+            mpfr_init2(p, MPFR_PREC_MIN);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                mpfr_prec_t prec = product_prec(al[i], au[i], bl[i], bu[i]);
+
+                lo[i] = &terms[2 * i];
+                hi[i] = &terms[2 * i + 1];
+                mpfr_init2(lo[i], prec);
+                mpfr_init2(hi[i], prec);
+                mpfr_set_prec(p, prec);
+
+                exact_product(lo[i], hi[i], p, al[i], au[i], bl[i], bu[i]);
+            }
+
+            mpfr_sum(rl, lo.data(), n, MPFR_RNDD);
+            mpfr_sum(ru, hi.data(), n, MPFR_RNDU);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                mpfr_clear(lo[i]);
+                mpfr_clear(hi[i]);
+            }
+            mpfr_clear(p);
+        }
+
+        //------------------------------------------------
+        // sum_i [a_i, b_i]
+        //------------------------------------------------
+
+        void sum(mpfr_ptr rl, mpfr_ptr ru, const mpfr_ptr *l, const mpfr_ptr *u, std::size_t n)
+        {
+            mpfr_sum(rl, l, n, MPFR_RNDD);
+            mpfr_sum(ru, u, n, MPFR_RNDU);
+        }
+
+        namespace
+        {
+            //------------------------------------------------
+            // every integer n with l <= n pi/2 <= u lies in
+            // [first, last]; the bounds of l / (pi/2) and
+            // u / (pi/2) are rounded outward, so the range may
+            // hold one extra n near an endpoint but never
+            // misses one. false when it does not fit a long.
+            //------------------------------------------------
+
+            bool half_pi_multiples(mpfr_srcptr l, mpfr_srcptr u, long &first, long &last)
+            {
+                mpfr_t lo, hi, q;
+                mpfr_inits2(std::max(mpfr_get_prec(l), mpfr_get_prec(u)) + 32, lo, hi, q, NULL);
+
+                mpfr_const_pi(lo, MPFR_RNDD);
+                mpfr_const_pi(hi, MPFR_RNDU);
+                mpfr_div_2ui(lo, lo, 1, MPFR_RNDD);
+                mpfr_div_2ui(hi, hi, 1, MPFR_RNDU);
+
+                bool fits = true;
+
+                mpfr_div(q, l, mpfr_sgn(l) >= 0 ? hi : lo, MPFR_RNDD);
+                mpfr_ceil(q, q);
+                fits = fits && mpfr_fits_slong_p(q, MPFR_RNDN);
+                first = fits ? mpfr_get_si(q, MPFR_RNDN) : 0;
+
+                mpfr_div(q, u, mpfr_sgn(u) >= 0 ? lo : hi, MPFR_RNDU);
+                mpfr_floor(q, q);
+                fits = fits && mpfr_fits_slong_p(q, MPFR_RNDN);
+                last = fits ? mpfr_get_si(q, MPFR_RNDN) : 0;
+
+                mpfr_clears(lo, hi, q, NULL);
+
+                return fits;
+            }
+
+            long mod4(long n)
+            {
+                return ((n % 4) + 4) % 4;
+            }
+        } // namespace
+
+        //------------------------------------------------
+        // sin and cos
+        //
+        // the extrema sit at n pi/2: maxima for
+        // n = top (mod 4) and minima for n = top + 2, with
+        // top = 1 for sin and 0 for cos. Without an
+        // extremum inside, the function is monotone and
+        // the next extremum above tells the direction.
+        //------------------------------------------------
+
+        void sin_cos(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr l, mpfr_srcptr u, bool cosine)
+        {
+            auto f = cosine ? mpfr_cos : mpfr_sin;
+            long top = cosine ? 0 : 1;
+
+            long first, last;
+            if (!half_pi_multiples(l, u, first, last) || last - first >= 3)
+            {
+                mpfr_set_si(rl, -1, MPFR_RNDD);
+                mpfr_set_si(ru, 1, MPFR_RNDU);
+                return;
+            }
+
+            bool has_max = false;
+            bool has_min = false;
+            for (long n = first; n <= last; ++n)
+            {
+                has_max = has_max || mod4(n - top) == 0;
+                has_min = has_min || mod4(n - top) == 2;
+            }
+
+            if (!has_max && !has_min)
+            {
+                long next = mod4(first - top) % 2 == 0 ? first : first + 1;
+                if (mod4(next - top) == 0)
+                {
+                    f(rl, l, MPFR_RNDD);
+                    f(ru, u, MPFR_RNDU);
+                }
+                else
+                {
+                    f(rl, u, MPFR_RNDD);
+                    f(ru, l, MPFR_RNDU);
+                }
+                return;
+            }
+
+            mpfr_t a, b;
+            mpfr_inits2(mpfr_get_prec(rl), a, b, NULL);
+
+            if (has_min)
+            {
+                mpfr_set_si(a, -1, MPFR_RNDD);
+            }
+            else
+            {
+                f(a, l, MPFR_RNDD);
+                f(b, u, MPFR_RNDD);
+                mpfr_min(a, a, b, MPFR_RNDD);
+            }
+            mpfr_set(rl, a, MPFR_RNDD);
+
+            if (has_max)
+            {
+                mpfr_set_si(a, 1, MPFR_RNDU);
+            }
+            else
+            {
+                f(a, l, MPFR_RNDU);
+                f(b, u, MPFR_RNDU);
+                mpfr_max(a, a, b, MPFR_RNDU);
+            }
+            mpfr_set(ru, a, MPFR_RNDU);
+
+            mpfr_clears(a, b, NULL);
+        }
+
+        //------------------------------------------------
+        // tan: poles at odd n pi/2, increasing between
+        //------------------------------------------------
+
+        bool tangent(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr l, mpfr_srcptr u)
+        {
+            long first, last;
+            if (!half_pi_multiples(l, u, first, last) || last > first || (last == first && first % 2 != 0))
+            {
+                return false;
+            }
+
+            mpfr_tan(rl, l, MPFR_RNDD);
+            mpfr_tan(ru, u, MPFR_RNDU);
+            return true;
+        }
+
+        //------------------------------------------------
+        // x^y is monotone in x and in y for x > 0, so the
+        // extrema over the box are at its corners
+        //------------------------------------------------
+
+        void power(mpfr_ptr rl, mpfr_ptr ru, mpfr_srcptr al, mpfr_srcptr au, mpfr_srcptr bl, mpfr_srcptr bu)
+        {
+            mpfr_t p;
+            mpfr_t lo, hi;
+            mpfr_inits2(mpfr_get_prec(rl), p, lo, hi, NULL);
+
+            mpfr_srcptr x[4] = {al, al, au, au};
+            mpfr_srcptr y[4] = {bl, bu, bl, bu};
+
+            mpfr_pow(lo, x[0], y[0], MPFR_RNDD);
+            mpfr_pow(hi, x[0], y[0], MPFR_RNDU);
+
+            for (int i = 1; i < 4; ++i)
+            {
+                mpfr_pow(p, x[i], y[i], MPFR_RNDD);
+                mpfr_min(lo, lo, p, MPFR_RNDD);
+
+                mpfr_pow(p, x[i], y[i], MPFR_RNDU);
+                mpfr_max(hi, hi, p, MPFR_RNDU);
+            }
+
+            mpfr_set(rl, lo, MPFR_RNDD);
+            mpfr_set(ru, hi, MPFR_RNDU);
+
+            mpfr_clears(p, lo, hi, NULL);
+        }
+    } // namespace detail
+
+    template class interval<mpfr_t, 53>;
+    template class interval<mpfr_t, 113>;
+    template class interval<mpfr_t, 256>;
+    template class interval<mpfr_t, 512>;
+    template class interval<mpfr_t, 1024>;
+
+} // namespace flib
@@ -1,3 +1,4 @@
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <cmath>
@@ -6,22 +7,14 @@
 #include "newton_function.hpp"
 #include "interval.hpp"
 #include "ap_number.hpp"
+#include "constants.hpp"
+#include "solver_trace.hpp"
+#include "batch.hpp"
 
 const uint precison = 53;
 
 namespace flib
 {
-    double newton(newton_function &f, double x)
-    {
-        for (int i = 0; i < 10; ++i)
-        {
-            fdh fdhx = f(x);
-            x = x - fdhx.f / fdhx.d;
-        }
-
-        return x;
-    }
-
     void test()
     {
         // double x = std::numbers::pi * 0.25;
@@ -35,56 +28,100 @@ namespace flib
 
     interval<mpfr_t, precison> f(interval<mpfr_t, precison> x)
     {
-        ArbitraryPrecision a("2", precison);
-        interval<mpfr_t, precison> y(a, a);
+        const auto &y = literal<precison>("2");
 
         return interval<mpfr_t, precison>::exp(x) - y;
     }
 
     interval<mpfr_t, precison> g(interval<mpfr_t, precison> x)
     {
-        ArbitraryPrecision a("2", precison);
-        ArbitraryPrecision b("1e-1024", precison);
-        interval<mpfr_t, precison> y(a, a);
-        interval<mpfr_t, precison> w(b, b);
+        const auto &y = literal<precison>("2");
+        const auto &w = literal<precison>("1e-1024");
 
         return (x - y) * (x - y) - w;
     }
 
     interval<mpfr_t, precison> dg(interval<mpfr_t, precison> x)
     {
-        ArbitraryPrecision a("2", precison);
-        ArbitraryPrecision b("4", precison);
-        interval<mpfr_t, precison> y(a, a);
-        interval<mpfr_t, precison> w(b, b);
+        const auto &y = literal<precison>("2");
+        const auto &w = literal<precison>("4");
 
         return y * x - w;
     }
 
-
 } // namespace flib
 
-int main()
+//----------------------------------------------------------------------------------------
+// AutoDiff [--trace file.csv | file.json]
+// AutoDiff --batch "expr" [options]     (see batch.hpp)
+//----------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
 {
-    uint number_digits = std::ceil(precison * std::log10(2));
+    if (argc > 1 && std::string(argv[1]) == "--batch")
+    {
+        std::ios::sync_with_stdio(false);
+        try
+        {
+            return flib::run_batch(flib::parse_batch_options(argc, argv));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
 
     using interval = flib::interval<mpfr_t, precison>;
     using ap = flib::ArbitraryPrecision;
 
+    std::string trace_path;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--trace")
+        {
+            trace_path = argv[i + 1];
+        }
+    }
+
+    flib::solver_trace trace;
 
     ap num1("2.1", precison);
     ap num2("3", precison);
 
     interval a(num1, num2);
+    double width = a.sup() - a.inf();
 
-    for (uint i = 0; i < 20; i++)
+    try
     {
+        for (uint i = 0; i < 20; i++)
+        {
+            a = interval::intersection(a, (a.mid() - (flib::g(a.mid()) / flib::dg(a))));
+
+            double previous = width;
+            width = a.sup() - a.inf();
+            trace.record(i, width, precison, previous > 0 ? width / previous : 0.0);
+        }
         std::cout << a << std::endl;
-        std::cout << (a.mid() - (flib::g(a.mid()) / flib::dg(a))) << std::endl;
+    }
+    catch (const std::domain_error &e)
+    {
+        // empty intersection: the Newton step proved there is no root in a
+        std::cout << "no root in " << a << ": " << e.what() << std::endl;
+    }
 
-        a = interval::intersection(a, (a.mid() - (flib::g(a.mid()) / flib::dg(a))));
+    if (!trace_path.empty())
+    {
+        std::ofstream out(trace_path);
+        if (trace_path.ends_with(".json"))
+        {
+            trace.write_json(out);
+        }
+        else
+        {
+            trace.write_csv(out);
+        }
     }
-    std::cout << a << std::endl;
 
     mpfr_free_cache(); // free the cache for constants like pi
 
@@ -0,0 +1,276 @@
+//----------------------------------------------------------------------------------------
+// testes de regressão da flib.
+//
+// Confere por amostragem que as funções elementares contêm a imagem exata perto das
+// fronteiras da redução de argumento, que fma e dot contêm os valores exatos, que o
+// Aberth cerca uma raiz dupla sem isolá-la e que o exemplo do otimizador do README
+// dá o mínimo certo. Retorna diferente de zero se alguma verificação falhar.
+//----------------------------------------------------------------------------------------
+
+#include "global_optimizer.hpp"
+#include "interval.hpp"
+#include "polynomial_roots.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+using namespace flib;
+
+using interval_t = interval<mpfr_t, 113>;
+
+namespace
+{
+    int checks = 0;
+    int failures = 0;
+
+    void expect(bool ok, const char *what, double a, double b)
+    {
+        ++checks;
+        if (!ok)
+        {
+            ++failures;
+            std::printf("FAIL %s [%.17g, %.17g]\n", what, a, b);
+        }
+    }
+
+    //---------------------------------------
+    // f(x) for sampled x in [a, b] lies in F([a, b])
+    //---------------------------------------
+
+    void contains(const char *name, const std::function<interval_t(const interval_t &)> &F,
+                  const std::function<double(double)> &f, double a, double b)
+    {
+        interval_t r = F(interval_t(a, b));
+        for (int i = 0; i <= 256; ++i)
+        {
+            double x = i == 256 ? b : a + (b - a) * i / 256.0;
+            double v = f(x);
+            double tol = 1e-13 * (1.0 + std::fabs(v));
+            expect(r.inf() <= v + tol && v - tol <= r.sup(), name, a, b);
+        }
+    }
+
+    void elementary_functions()
+    {
+        const double half_pi = std::numbers::pi / 2;
+        const double widths[] = {0.0, 1e-12, 1e-8, 1e-4, 0.1, 1.0};
+
+        for (int k = -12; k <= 12; ++k)
+        {
+            double c = k * half_pi;
+            for (double w : widths)
+            {
+                for (auto [a, b] : {std::pair{c - w, c + w}, std::pair{c, c + w}, std::pair{c - w, c}})
+                {
+                    contains("sin", [](const interval_t &x) { return interval_t::sin(x); },
+                             [](double x) { return std::sin(x); }, a, b);
+                    contains("cos", [](const interval_t &x) { return interval_t::cos(x); },
+                             [](double x) { return std::cos(x); }, a, b);
+
+                    // tan only on intervals clearly away from its poles
+                    if (k % 2 == 0 && w <= 0.1)
+                    {
+                        contains("tan", [](const interval_t &x) { return interval_t::tan(x); },
+                                 [](double x) { return std::tan(x); }, a, b);
+                    }
+                }
+            }
+
+            if (k % 2 != 0)
+            {
+                bool thrown = false;
+                try
+                {
+                    interval_t::tan(interval_t(c - 0.1, c + 0.1));
+                }
+                catch (const std::domain_error &)
+                {
+                    thrown = true;
+                }
+                expect(thrown, "tan across a pole", c - 0.1, c + 0.1);
+            }
+        }
+
+        for (double c : {-1.0, 0.0, 1.0})
+        {
+            for (double w : widths)
+            {
+                for (auto [a, b] : {std::pair{c - w, c + w}, std::pair{c, c + w}, std::pair{c - w, c}})
+                {
+                    contains("cosh", [](const interval_t &x) { return interval_t::cosh(x); },
+                             [](double x) { return std::cosh(x); }, a, b);
+
+                    for (int p = -3; p <= 4; ++p)
+                    {
+                        if (p < 0 && a <= 0.0 && 0.0 <= b)
+                        {
+                            continue;
+                        }
+                        contains("x_pwr_k", [p](const interval_t &x) { return interval_t::x_pwr_k(x, p); },
+                                 [p](double x) { return std::pow(x, p); }, a, b);
+                    }
+                }
+            }
+        }
+
+        // pow on a grid of boxes of the base and the exponent
+        for (auto [xa, xb] : {std::pair{0.5, 0.5}, std::pair{0.5, 1.0}, std::pair{0.9, 1.1}, std::pair{1.0, 3.0}})
+        {
+            for (auto [ya, yb] : {std::pair{-2.0, -1.0}, std::pair{-0.5, 0.5}, std::pair{0.0, 0.0}, std::pair{1.5, 2.5}})
+            {
+                interval_t r = interval_t::pow(interval_t(xa, xb), interval_t(ya, yb));
+                for (int i = 0; i <= 16; ++i)
+                {
+                    for (int j = 0; j <= 16; ++j)
+                    {
+                        double v = std::pow(xa + (xb - xa) * i / 16.0, ya + (yb - ya) * j / 16.0);
+                        double tol = 1e-13 * (1.0 + std::fabs(v));
+                        expect(r.inf() <= v + tol && v - tol <= r.sup(), "pow", xa, ya);
+                    }
+                }
+            }
+        }
+    }
+
+    //---------------------------------------
+    // fma and dot hold the exact results
+    //---------------------------------------
+
+    void fused_operations()
+    {
+        std::mt19937 generator(37);
+        std::uniform_real_distribution<double> centre(-10.0, 10.0), width(0.0, 1.0);
+
+        auto random_interval = [&]()
+        {
+            double a = centre(generator);
+            return std::pair{a, a + width(generator)};
+        };
+
+        for (int n = 0; n < 500; ++n)
+        {
+            auto [al, au] = random_interval();
+            auto [bl, bu] = random_interval();
+            auto [cl, cu] = random_interval();
+            interval_t r = interval_t::fma(interval_t(al, au), interval_t(bl, bu), interval_t(cl, cu));
+            for (double a : {al, au, (al + au) / 2})
+            {
+                for (double b : {bl, bu, (bl + bu) / 2})
+                {
+                    for (double c : {cl, cu})
+                    {
+                        double v = std::fma(a, b, c);
+                        double tol = 1e-14 * (1.0 + std::fabs(a * b) + std::fabs(c));
+                        expect(r.inf() <= v + tol && v - tol <= r.sup(), "fma", a, b);
+                    }
+                }
+            }
+        }
+
+        for (int n = 0; n < 200; ++n)
+        {
+            std::vector<interval_t> a, b;
+            std::vector<std::pair<double, double>> ab, bb;
+            for (int i = 0; i < 8; ++i)
+            {
+                ab.push_back(random_interval());
+                bb.push_back(random_interval());
+                a.emplace_back(ab.back().first, ab.back().second);
+                b.emplace_back(bb.back().first, bb.back().second);
+            }
+            interval_t r = interval_t::dot(a, b);
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                long double v = 0.0L, magnitude = 0.0L;
+                for (int i = 0; i < 8; ++i)
+                {
+                    double x = corner & 1 ? ab[i].first : ab[i].second;
+                    double y = corner & 2 ? bb[i].first : bb[i].second;
+                    v += static_cast<long double>(x) * y;
+                    magnitude += std::fabs(static_cast<long double>(x) * y);
+                }
+                double tol = static_cast<double>(1e-14L * (1.0L + magnitude));
+                expect(r.inf() <= v + tol && v - tol <= r.sup(), "dot", r.inf(), r.sup());
+            }
+        }
+
+        // cancellation a double loop would lose: 1e16 + 1 - 1e16 = 1
+        std::vector<interval_t> a{interval_t(1e16, 1e16), interval_t(1.0, 1.0), interval_t(-1e16, -1e16)};
+        std::vector<interval_t> b(3, interval_t(1.0, 1.0));
+        interval_t r = interval_t::dot(a, b);
+        expect(r.inf() <= 1.0 && 1.0 <= r.sup() && r.sup() - r.inf() < 1e-6, "dot cancellation", r.inf(), r.sup());
+    }
+
+    //---------------------------------------
+    // (z - 1)^2 (z + 2) = z^3 - 3z + 2
+    //---------------------------------------
+
+    void double_root()
+    {
+        std::vector<std::complex<double>> a{2.0, -3.0, 0.0, 1.0};
+        polynomial_roots r = aberth(std::span<const std::complex<double>>(a));
+
+        for (std::complex<double> z : {std::complex<double>(1.0), std::complex<double>(1.0), std::complex<double>(-2.0)})
+        {
+            bool enclosed = false;
+            for (std::size_t i = 0; i < r.roots.size(); ++i)
+            {
+                enclosed = enclosed || std::abs(r.roots[i] - z) <= r.radius[i];
+            }
+            expect(enclosed, "aberth inclusion", z.real(), z.imag());
+        }
+
+        for (std::size_t i = 0; i < r.roots.size(); ++i)
+        {
+            if (std::abs(r.roots[i] - 1.0) <= r.radius[i])
+            {
+                expect(!r.isolated[i], "aberth double root isolated", r.roots[i].real(), r.radius[i]);
+            }
+        }
+    }
+
+    //---------------------------------------
+    // the global optimization example of README.md
+    //---------------------------------------
+
+    void readme_optimizer()
+    {
+        interval<mpfr_t, 113> two(2.0, 2.0);
+        auto f = [&](const interval<mpfr_t, 113> &x) { return x * x - two * x; };
+        auto df = [&](const interval<mpfr_t, 113> &x) { return two * x - two; };
+        auto d2f = [&](const interval<mpfr_t, 113> &) { return two; };
+        auto fp = [](double x) { return x * x - 2 * x; };
+
+        for (unsigned threads : {1u, 4u})
+        {
+            optimizer_result r = global_minimize<113>(f, df, d2f, fp, -3.0, 4.0, {1e-8, threads});
+            expect(r.lower_bound <= -1.0 && -1.0 <= r.upper_bound && r.upper_bound - r.lower_bound < 1e-6,
+                   "optimizer bounds", r.lower_bound, r.upper_bound);
+
+            bool found = false;
+            for (const optimizer_box &box : r.boxes)
+            {
+                found = found || (box.lo <= 1.0 && 1.0 <= box.hi);
+            }
+            expect(found, "optimizer minimizer box", r.minimizer, static_cast<double>(r.boxes.size()));
+        }
+    }
+} // namespace
+
+int main()
+{
+    elementary_functions();
+    fused_operations();
+    double_root();
+    readme_optimizer();
+
+    std::printf("%d checks, %d failures\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}